@@ -0,0 +1,467 @@
+/**
+ * @file bench.cpp - Lookup latency benchmark for the hash table variants.
+ *
+ * @brief - Loads a key file into every table variant, then times each
+ * lookup of a shuffled query stream (the keys themselves plus a file of
+ * mostly absent words) and reports the latency distribution. Tail
+ * percentiles are what separate the chained table, whose worst case is
+ * its longest chain, from the cuckoo table, whose worst case is two
+ * buckets. The filtered row is the chained table behind a membership
+ * filter, which mostly changes the cost of the misses, and the radix
+ * row is the RadixTree dictionary, which also answers the prefix queries
+ * timed after it. The static row is the StaticHash built over the keys,
+ * saved and mapped back with load, so its one probe lookups read the
+ * file mapping. A second table compares the generic HashMap with
+ * std::unordered_map on the same words, a third compares chain nodes
+ * from malloc with nodes from a NodePool on a larger key set derived
+ * from the corpus, and the last streams a Zipf distributed sample of the
+ * keys through WordFrequency and checks its estimates against exact
+ * counts.
+ *
+ *    ./hashbench [key file] [query file] [rounds]
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "hash.h"
+#include "hash_map.h"
+#include "node_pool.h"
+#include <sys/wait.h>
+#include <unistd.h>
+#include "cuckoo_hash.h"
+#include "word_frequency.h"
+#include "radix_tree.h"
+#include "static_hash.h"
+
+using std::cout;
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+
+/**
+ * Reads every whitespace separated word of a file
+ *
+ * @param filename - Name of the word file
+ */
+static vector<string> readWords(string filename)
+{
+	vector<string> words;
+	string word;
+	std::ifstream input_file(filename);
+
+	while (input_file >> word) {
+
+		words.push_back(word);
+	}
+
+	return words;
+}
+
+
+/**
+ * Times every lookup of queries and prints the latency distribution
+ *
+ * @param name - Label of the table variant
+ * @param queries - Words to look up, in order
+ * @param lookup - Callable returning true when a word is present
+ */
+template <class Lookup>
+static void timeLookups(string name, const vector<string>& queries,
+	Lookup lookup)
+{
+	vector<double> latency;
+	size_t hits = 0;
+
+	latency.reserve(queries.size());
+
+	Clock::time_point begin = Clock::now();
+
+	for (const auto& word : queries) {
+
+		Clock::time_point start = Clock::now();
+		hits += lookup(word);
+		latency.push_back(
+			std::chrono::duration<double, std::nano>(Clock::now() - start).count());
+	}
+
+	double total = std::chrono::duration<double>(Clock::now() - begin).count();
+
+	std::sort(latency.begin(), latency.end());
+
+	auto percentile = [&latency](double p) {
+
+		return latency[std::min(latency.size() - 1,
+			(size_t)(p * latency.size()))];
+	};
+
+	cout << std::left << setw(10) << name << std::right << std::fixed
+		<< std::setprecision(0)
+		<< setw(12) << queries.size() / total
+		<< setw(9) << percentile(0.50)
+		<< setw(9) << percentile(0.99)
+		<< setw(9) << percentile(0.999)
+		<< setw(10) << latency.back()
+		<< setw(9) << hits << endl;
+}
+
+
+/**
+ * Runs work once and returns the elapsed time in seconds
+ */
+template <class Work>
+static double secondsFor(Work work)
+{
+	Clock::time_point start = Clock::now();
+
+	work();
+
+	return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+
+/**
+ * Counts every key into a word -> count map, then looks up every query,
+ * and prints insert and lookup throughput
+ *
+ * @param name - Label of the map
+ * @param map - Empty map from string to unsigned int
+ * @param keys - Words to count
+ * @param queries - Words to look up
+ */
+template <class Map>
+static void timeMap(string name, Map& map, const vector<string>& keys,
+	const vector<string>& queries)
+{
+	size_t hits = 0;
+
+	double insert = secondsFor([&]() {
+
+		for (const auto& word : keys) {
+
+			map.try_emplace(word, 0u).first->second++;
+		}
+	});
+
+	double lookup = secondsFor([&]() {
+
+		for (const auto& word : queries) {
+
+			hits += map.find(word) != map.end();
+		}
+	});
+
+	cout << std::left << setw(15) << name << std::right << std::fixed
+		<< std::setprecision(0)
+		<< setw(14) << keys.size() / insert
+		<< setw(14) << queries.size() / lookup
+		<< setw(9) << hits << endl;
+}
+
+
+/**
+ * Resident set size of this process in bytes
+ */
+static long residentBytes()
+{
+	long pages = 0;
+	long resident = 0;
+	std::ifstream statm("/proc/self/statm");
+
+	statm >> pages >> resident;
+
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+
+/**
+ * Builds a map over keys in a child process, so the resident set growth
+ * belongs to this map alone, and prints insert throughput, RSS growth per
+ * key and the time to destroy the map
+ *
+ * @param name - Label of the allocator
+ * @param keys - Distinct words to insert
+ */
+template <class Map>
+static void timeAllocator(string name, const vector<string_view>& keys)
+{
+	cout.flush();
+
+	pid_t child = fork();
+
+	if (child == 0) {
+
+		long before = residentBytes();
+		Map *map = new Map;
+
+		double insert = secondsFor([&]() {
+
+			for (auto word : keys) {
+
+				map->try_emplace(word, 1u);
+			}
+		});
+
+		long grown = residentBytes() - before;
+		double destroy = secondsFor([&]() {
+
+			delete map;
+		});
+
+		cout << std::left << setw(15) << name << std::right << std::fixed
+			<< std::setprecision(0)
+			<< setw(14) << keys.size() / insert
+			<< setw(14) << std::setprecision(1) << (double)grown / keys.size()
+			<< setw(14) << std::setprecision(2) << destroy * 1000 << endl;
+		cout.flush();
+		_exit(0);
+	}
+
+	waitpid(child, nullptr, 0);
+}
+
+
+/**
+ * main
+ *
+ * @brief
+ *    builds every table variant from the key file and benchmarks lookups
+ */
+int main(int argc, char *argv[])
+{
+	string keyFile = argc > 1 ? argv[1] : "sgb-words.txt";
+	string queryFile = argc > 2 ? argv[2] : "random.txt";
+	int rounds = argc > 3 ? atoi(argv[3]) : 20;
+
+	vector<string> keys = readWords(keyFile);
+	vector<string> queries;
+
+	for (int r = 0; r < rounds; r++) {
+
+		queries.insert(queries.end(), keys.begin(), keys.end());
+
+		vector<string> misses = readWords(queryFile);
+		queries.insert(queries.end(), misses.begin(), misses.end());
+	}
+
+	std::shuffle(queries.begin(), queries.end(), std::mt19937(42));
+
+	GrowingHash *chained = new GrowingHash;
+	chained->processFile(keyFile);
+
+	GrowingHash *filtered = new GrowingHash;
+	filtered->enableFilter(keys.size(), 0.01);
+	filtered->processFile(keyFile);
+
+	CuckooHash cuckoo;
+	cuckoo.loadFile(keyFile);
+
+	RadixTree radix;
+	radix.loadFile(keyFile);
+
+	// lookups go to the mapped copy, the file can go once it is mapped
+	StaticHash built;
+	StaticHash mapped;
+	string staticFile = "hashbench-" + std::to_string(getpid()) + ".phash";
+
+	if (!built.buildFromFile(keyFile) || !built.save(staticFile)
+		|| !mapped.load(staticFile)) {
+
+		std::cerr << "hashbench: cannot build " << staticFile << endl;
+		unlink(staticFile.c_str());
+		return 1;
+	}
+
+	unlink(staticFile.c_str());
+
+	cout << keys.size() << " keys, " << queries.size() << " lookups, "
+		<< chained->bucketCount() << " chained buckets, " << cuckoo.bucketCount()
+		<< " cuckoo buckets" << endl;
+	cout << std::left << setw(10) << "table" << std::right
+		<< setw(12) << "ops/s" << setw(9) << "p50 ns" << setw(9) << "p99 ns"
+		<< setw(9) << "p999 ns" << setw(10) << "max ns" << setw(9) << "hits"
+		<< endl;
+
+	timeLookups("chained", queries, [chained](const string& word) {
+
+		return chained->search(word);
+	});
+
+	timeLookups("filtered", queries, [filtered](const string& word) {
+
+		return filtered->search(word);
+	});
+
+	timeLookups("cuckoo", queries, [&cuckoo](const string& word) {
+
+		return cuckoo.search(word);
+	});
+
+	timeLookups("radix", queries, [&radix](const string& word) {
+
+		return radix.search(word);
+	});
+
+	timeLookups("static", queries, [&mapped](const string& word) {
+
+		return mapped.search(word);
+	});
+
+	cout << "memory per key: chained " << std::setprecision(1)
+		<< (double)chained->memoryUsage() / keys.size() << " B, cuckoo "
+		<< (double)cuckoo.memoryUsage() / keys.size() << " B, static "
+		<< (double)mapped.memoryUsage() / keys.size() << " B, radix "
+		<< (double)radix.memoryUsage() / keys.size() << " B ("
+		<< radix.nodeCount(4) << " node4, " << radix.nodeCount(16)
+		<< " node16, " << radix.nodeCount(48) << " node48, "
+		<< radix.nodeCount(256) << " node256)" << endl;
+
+	// every two letter prefix, the kind of query a hash table cannot answer
+	size_t matched = 0;
+	Clock::time_point begin = Clock::now();
+
+	for (int r = 0; r < rounds; r++) {
+
+		char prefix[2];
+
+		for (prefix[0] = 'a'; prefix[0] <= 'z'; prefix[0]++) {
+
+			for (prefix[1] = 'a'; prefix[1] <= 'z'; prefix[1]++) {
+
+				radix.forEachPrefixed(string_view(prefix, 2),
+					[&matched](string_view) { matched++; });
+			}
+		}
+	}
+
+	double elapsed = std::chrono::duration<double>(Clock::now() - begin).count();
+
+	cout << "radix prefixes: " << std::setprecision(0)
+		<< 26 * 26 * rounds / elapsed << " queries/s, "
+		<< matched / elapsed << " words/s" << endl;
+
+	const MembershipFilter *filter = filtered->membershipFilter();
+
+	cout << "filter: " << filter->memoryUsage() << " bytes, "
+		<< filter->probes() << " probes, rejected " << filter->rejected()
+		<< " of " << filter->queries() << ", false positive rate "
+		<< std::setprecision(4) << filter->falsePositiveRate() << endl;
+
+	vector<string> counted;
+
+	for (int r = 0; r < rounds; r++) {
+
+		counted.insert(counted.end(), keys.begin(), keys.end());
+	}
+
+	cout << endl << std::left << setw(15) << "map" << std::right
+		<< setw(14) << "inserts/s" << setw(14) << "lookups/s" << setw(9)
+		<< "hits" << endl;
+
+	HashMap<string, unsigned int> generic;
+	timeMap("HashMap", generic, counted, queries);
+
+	std::unordered_map<string, unsigned int> standard;
+	timeMap("unordered_map", standard, counted, queries);
+
+	vector<string> derived;
+	vector<string_view> derivedViews;
+
+	for (const auto& word : keys) {
+
+		for (int suffix = 0; suffix < 100; suffix++) {
+
+			derived.push_back(word + std::to_string(suffix));
+		}
+	}
+
+	derivedViews.assign(derived.begin(), derived.end());
+
+	cout << endl << std::left << setw(15) << "nodes from" << std::right
+		<< setw(14) << "inserts/s" << setw(14) << "RSS B/key" << setw(14)
+		<< "destroy ms" << "   (" << derived.size() << " keys)" << endl;
+
+	typedef HashMap<string_view, unsigned int> MallocMap;
+	typedef HashMap<string_view, unsigned int, std::hash<string_view>,
+		std::equal_to<string_view>,
+		PoolAllocator<std::pair<const string_view, unsigned int> > > PoolMap;
+
+	timeAllocator<MallocMap>("malloc", derivedViews);
+	timeAllocator<PoolMap>("NodePool", derivedViews);
+
+	vector<double> weights;
+
+	for (size_t rank = 0; rank < keys.size(); rank++) {
+
+		weights.push_back(1.0 / (rank + 1));
+	}
+
+	std::mt19937 random(7);
+	std::discrete_distribution<size_t> zipf(weights.begin(), weights.end());
+	vector<string_view> stream;
+	std::unordered_map<string_view, uint64_t> truth;
+
+	for (size_t i = 0; i < 100 * keys.size(); i++) {
+
+		stream.push_back(keys[zipf(random)]);
+		truth[stream.back()]++;
+	}
+
+	WordFrequency frequency(0.0001, 0.001, 100);
+	frequency.track(keys[0]);
+
+	double seconds = secondsFor([&frequency, &stream]() {
+
+		for (string_view word : stream) {
+
+			frequency.add(word);
+		}
+	});
+
+	uint64_t worst = 0;
+
+	for (const auto& entry : truth) {
+
+		worst = std::max(worst, frequency.estimate(entry.first) - entry.second);
+	}
+
+	int found = 0;
+	vector<HeavyHitter> top = frequency.topK();
+
+	for (size_t rank = 0; rank < 10; rank++) {
+
+		for (size_t i = 0; i < 10 && i < top.size(); i++) {
+
+			found += top[i].word == keys[rank];
+		}
+	}
+
+	uint64_t exact = 0;
+	frequency.exact(keys[0], exact);
+
+	cout << endl << "frequency: "
+		<< (uint64_t)(stream.size() / seconds) << " words/s over " << stream.size()
+		<< " Zipf words, " << frequency.memoryUsage() << " bytes ("
+		<< frequency.depth() << "x" << frequency.width() << " sketch)" << endl
+		<< "worst overestimate " << worst << ", top 10 recovered " << found
+		<< "/10, tracked \"" << keys[0] << "\" " << exact << " of "
+		<< truth[keys[0]] << endl;
+
+	delete chained;
+	delete filtered;
+
+	return 0;
+}
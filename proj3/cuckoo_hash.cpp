@@ -0,0 +1,446 @@
+/**
+ * @file cuckoo_hash.cpp - Insertion, lookup and removal for the
+ * bucketized cuckoo hash set.
+ *
+ * @brief - Slots keep the full 64-bit hash of their key, so both candidate
+ * buckets of a victim are known without rehashing its characters, and a
+ * slot is only compared against the arena when the hashes already match.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <cstring>
+#include "cuckoo_hash.h"
+#include "hash_mix.h"
+#include "mapped_file.h"
+#include "word_loader.h"
+
+
+/**
+ * Constructor
+ *
+ * @param expected - Number of keys the table should hold before growing
+ */
+CuckooHash::CuckooHash(size_t expected)
+{
+	size_t wanted = 2;
+
+	while (wanted * SLOTS * 9 / 10 < expected) {
+
+		wanted *= 2;
+	}
+
+	Bucket empty = Bucket();
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		empty.slots[s].length = EMPTY;
+	}
+
+	buckets.assign(wanted, empty);
+	mask = wanted - 1;
+	seed = mix64(1);
+	random = 0x2545f4914f6cdd1dULL;
+	count = 0;
+	rehashCount = 0;
+}
+
+
+/**
+ * Checks whether a slot holds word
+ */
+bool CuckooHash::matches(const Slot& slot, string_view word,
+	uint64_t hash) const
+{
+	return slot.hash == hash && slot.length == word.size()
+		&& memcmp(arena.view(slot.offset, slot.length).data(), word.data(),
+			word.size()) == 0;
+}
+
+
+/**
+ * Searches the two candidate buckets of word, then the stash
+ *
+ * @param word - Key we are searching for
+ */
+bool CuckooHash::search(string_view word) const
+{
+	uint64_t hash = hashBytes(word, seed);
+	const Bucket& first = buckets[firstBucket(hash)];
+	const Bucket& second = buckets[secondBucket(hash)];
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		if (matches(first.slots[s], word, hash)) {
+
+			return true;
+		}
+	}
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		if (matches(second.slots[s], word, hash)) {
+
+			return true;
+		}
+	}
+
+	for (const auto& item : stash) {
+
+		if (matches(item, word, hash)) {
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Number of table buckets (cache lines) a lookup of word reads: 1 if the
+ * key is in its first bucket, 2 otherwise, plus 1 when the stash is read.
+ *
+ * @param word - Key to probe for
+ */
+unsigned int CuckooHash::probes(string_view word) const
+{
+	uint64_t hash = hashBytes(word, seed);
+	const Bucket& first = buckets[firstBucket(hash)];
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		if (matches(first.slots[s], word, hash)) {
+
+			return 1;
+		}
+	}
+
+	const Bucket& second = buckets[secondBucket(hash)];
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		if (matches(second.slots[s], word, hash)) {
+
+			return 2;
+		}
+	}
+
+	return stash.empty() ? 2 : 3;
+}
+
+
+/**
+ * Adds word to the set
+ *
+ * @param word - Key to be inserted
+ *
+ * @return false if word was already present
+ */
+bool CuckooHash::insert(string_view word)
+{
+	if (search(word)) {
+
+		return false;
+	}
+
+	Slot item;
+
+	item.hash = hashBytes(word, seed);
+	item.offset = arena.intern(word);
+	item.length = (unsigned int)word.size();
+
+	if (count + 1 > buckets.size() * SLOTS * 95 / 100) {
+
+		rehash(buckets.size() * 2, nullptr);
+		item.hash = hashBytes(word, seed);
+	}
+
+	count++;
+
+	if (!place(item)) {
+
+		if (stash.size() < STASH_LIMIT) {
+
+			stash.push_back(item);
+		}
+		else {
+
+			rehash(buckets.size() * 2, &item);
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Puts item in a free slot of bucket
+ *
+ * @return false if the bucket is full
+ */
+bool CuckooHash::tryBucket(size_t bucket, const Slot& item)
+{
+	for (int s = 0; s < SLOTS; s++) {
+
+		if (buckets[bucket].slots[s].length == EMPTY) {
+
+			buckets[bucket].slots[s] = item;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Places item in one of its buckets, evicting keys to their other bucket
+ * along a random walk when both are full.
+ *
+ * @param item - Key to place. When placement fails it holds the key that
+ * was left without a slot, which may be another key than the one passed.
+ *
+ * @return false if MAX_KICKS evictions were not enough
+ */
+bool CuckooHash::place(Slot& item)
+{
+	if (tryBucket(firstBucket(item.hash), item)
+		|| tryBucket(secondBucket(item.hash), item)) {
+
+		return true;
+	}
+
+	size_t bucket = firstBucket(item.hash);
+
+	for (int kick = 0; kick < MAX_KICKS; kick++) {
+
+		random ^= random << 13;
+		random ^= random >> 7;
+		random ^= random << 17;
+
+		Slot& victim = buckets[bucket].slots[random % SLOTS];
+		Slot evicted = victim;
+
+		victim = item;
+		item = evicted;
+
+		bucket = firstBucket(item.hash) == bucket
+			? secondBucket(item.hash) : firstBucket(item.hash);
+
+		if (tryBucket(bucket, item)) {
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Rebuilds the table with a new seed and newBucketCount buckets. If the
+ * new table still cannot hold every key it is doubled again.
+ *
+ * @param newBucketCount - Power of two number of buckets
+ * @param homeless - Key that has not been placed yet, or nullptr
+ */
+void CuckooHash::rehash(size_t newBucketCount, Slot *homeless)
+{
+	vector<Slot> all;
+
+	all.reserve(count + 1);
+
+	for (const auto& bucket : buckets) {
+
+		for (int s = 0; s < SLOTS; s++) {
+
+			if (bucket.slots[s].length != EMPTY) {
+
+				all.push_back(bucket.slots[s]);
+			}
+		}
+	}
+
+	all.insert(all.end(), stash.begin(), stash.end());
+
+	if (homeless != nullptr) {
+
+		all.push_back(*homeless);
+	}
+
+	Bucket empty = Bucket();
+
+	for (int s = 0; s < SLOTS; s++) {
+
+		empty.slots[s].length = EMPTY;
+	}
+
+	while (true) {
+
+		rehashCount++;
+		seed = mix64(seed + rehashCount);
+		buckets.assign(newBucketCount, empty);
+		mask = newBucketCount - 1;
+		stash.clear();
+
+		bool placed = true;
+
+		for (auto item : all) {
+
+			item.hash = hashBytes(arena.view(item.offset, item.length), seed);
+
+			if (!place(item)) {
+
+				if (stash.size() < STASH_LIMIT) {
+
+					stash.push_back(item);
+				}
+				else {
+
+					placed = false;
+					break;
+				}
+			}
+		}
+
+		if (placed) {
+
+			return;
+		}
+
+		newBucketCount *= 2;
+	}
+}
+
+
+/**
+ * Moves stashed keys back into the table once room has been freed
+ */
+void CuckooHash::drainStash()
+{
+	for (size_t i = 0; i < stash.size(); ) {
+
+		if (tryBucket(firstBucket(stash[i].hash), stash[i])
+			|| tryBucket(secondBucket(stash[i].hash), stash[i])) {
+
+			stash.erase(stash.begin() + i);
+		}
+		else {
+
+			i++;
+		}
+	}
+}
+
+
+/**
+ * Removes word from the set. Its characters stay in the arena.
+ *
+ * @param word - Key to be removed
+ *
+ * @return false if word was not present
+ */
+bool CuckooHash::remove(string_view word)
+{
+	uint64_t hash = hashBytes(word, seed);
+	size_t candidates[2] = { firstBucket(hash), secondBucket(hash) };
+
+	for (size_t bucket : candidates) {
+
+		for (int s = 0; s < SLOTS; s++) {
+
+			if (matches(buckets[bucket].slots[s], word, hash)) {
+
+				buckets[bucket].slots[s].length = EMPTY;
+				count--;
+				drainStash();
+				return true;
+			}
+		}
+	}
+
+	for (size_t i = 0; i < stash.size(); i++) {
+
+		if (matches(stash[i], word, hash)) {
+
+			stash.erase(stash.begin() + i);
+			count--;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Inserts every word of a word file
+ *
+ * @param filename - Name of the word file
+ *
+ * @return false if the file could not be mapped
+ */
+bool CuckooHash::loadFile(string filename)
+{
+	MappedFile file;
+
+	if (!file.open(filename)) {
+
+		return false;
+	}
+
+	forEachWord(file.data(), file.size(), [this](string_view word) {
+
+		insert(word);
+	});
+
+	return true;
+}
+
+
+/**
+ * Number of keys in the set
+ */
+size_t CuckooHash::size() const
+{
+	return count;
+}
+
+
+/**
+ * Number of buckets in the table
+ */
+size_t CuckooHash::bucketCount() const
+{
+	return buckets.size();
+}
+
+
+/**
+ * Number of keys waiting in the stash
+ */
+size_t CuckooHash::stashSize() const
+{
+	return stash.size();
+}
+
+
+/**
+ * Number of times the table has been rebuilt with a new seed
+ */
+unsigned int CuckooHash::rehashes() const
+{
+	return rehashCount;
+}
+
+
+/**
+ * Bytes used by the buckets, the stash and the key arena
+ */
+size_t CuckooHash::memoryUsage() const
+{
+	return buckets.capacity() * sizeof(Bucket)
+		+ stash.capacity() * sizeof(Slot) + arena.capacity();
+}
@@ -0,0 +1,90 @@
+/**
+ * @file cuckoo_hash.h - Declaration of the bucketized cuckoo hash set.
+ *
+ * @brief - Every key has two candidate buckets of four slots, and a bucket
+ * is exactly one 64-byte cache line, so a lookup touches at most two cache
+ * lines of the table no matter how full it is. A key that cannot be placed
+ * after a bounded number of evictions waits in a small stash; when the
+ * stash is full the table is rehashed with a new seed and doubled.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __CUCKOO_HASH_H
+#define __CUCKOO_HASH_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "string_arena.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+class CuckooHash {
+
+public:
+	CuckooHash(size_t expected = 0);
+	bool insert(string_view word);           // false if already present
+	bool search(string_view word) const;     // probe two buckets and stash
+	bool remove(string_view word);           // false if not present
+	bool loadFile(string filename);          // insert every word of a file
+	unsigned int probes(string_view word) const;  // buckets a lookup reads
+	size_t size() const;
+	size_t bucketCount() const;
+	size_t stashSize() const;
+	unsigned int rehashes() const;           // number of rehashes so far
+	size_t memoryUsage() const;
+
+private:
+	static const int SLOTS = 4;              // slots per bucket
+	static const size_t STASH_LIMIT = 4;     // keys allowed in the stash
+	static const int MAX_KICKS = 500;        // evictions before giving up
+
+	struct Slot {
+
+		uint64_t hash;               // hashBytes(key, seed)
+		uint32_t offset;             // key characters in the arena
+		uint32_t length;             // EMPTY marks a free slot
+	};
+
+	struct alignas(64) Bucket {
+
+		Slot slots[SLOTS];
+	};
+
+	static const uint32_t EMPTY = 0xFFFFFFFF;
+
+	vector<Bucket> buckets;
+	vector<Slot> stash;
+	StringArena arena;
+	uint64_t seed;
+	uint64_t random;                 // xorshift state for picking victims
+	size_t mask;                     // bucket count - 1
+	size_t count;
+	unsigned int rehashCount;
+
+	size_t firstBucket(uint64_t hash) const
+	{
+		return hash & mask;
+	}
+
+	size_t secondBucket(uint64_t hash) const
+	{
+		size_t index = (hash >> 32) & mask;
+
+		return index == firstBucket(hash) ? index ^ (mask & 1) : index;
+	}
+
+	bool matches(const Slot& slot, string_view word, uint64_t hash) const;
+	bool place(Slot& item);
+	bool tryBucket(size_t bucket, const Slot& item);
+	void rehash(size_t newBucketCount, Slot *homeless);
+	void drainStash();
+};
+
+#endif
@@ -1,40 +1,169 @@
 /* This assignment originated at UC Riverside. The hash table size
- should be defined at compile time. Use -D HASH_TABLE_SIZE=X */
+ is fixed at compile time by the Capacity policy, Hash is the 10 bucket
+ table of the assignment. */
 
 #ifndef __HASH_H
 #define __HASH_H
 
 #include <string>
-#include <list>
+#include <string_view>
+#include <vector>
+#include <cstddef>
+#include <memory>
+#include <functional>
+#include <cstring>
+#include "string_arena.h"
+#include "short_key.h"
+#include "membership_filter.h"
+#include "hash_map.h"
+#include "hash_policies.h"
+#include "node_pool.h"
 
 using std::string;
-using std::list;
+using std::string_view;
+using std::vector;
 
-class Hash {
+/**
+ * A key being looked up, with its hash computed once. Keys of at most
+ * SHORT_KEY characters are also packed, the way the arena stores them.
+ */
+struct KeyQuery {
+
+   string_view word;
+   unsigned int hash;
+   alignas(16) char packed[SHORT_KEY];
+};
+
+/**
+ * Key hash policies. hash() is given a KeyQuery whose packed slot is
+ * filled when the key is short.
+ */
+struct PackedKeyHash {              // 16-byte mix, hashBytes when long
+   static unsigned int hash(const KeyQuery& key);
+};
+
+struct SeededKeyHash {              // hashBytes for every length
+   static unsigned int hash(const KeyQuery& key)
+   {
+      return (unsigned int)hashBytes(key.word, 0);
+   }
+};
+
+/**
+ * The table with its policies as template parameters; the members are
+ * defined in hash_impl.h, so any combination can be used. The
+ * configurations below are compiled once, in hash.cpp.
+ */
+template <class Capacity, class Growth = NoGrowth,
+   class Collision = ChainAppend, class KeyHasher = PackedKeyHash>
+class BasicHash {
 
 public:
-   Hash();                          // constructor
-   void remove(string);             // remove key from hash table
+   BasicHash(size_t buckets = 16);  // constructor, buckets if not static
+   void remove(string_view);        // remove key from hash table
    void print();                    // print the entire hash table
    void processFile(string);        // open file and add keys to hash table
-   bool search(string);             // search for a key in the hash table
+   bool search(string_view);        // search for a key in the hash table
    void output(string);             // print entire hash table to a file
    void printStats();               // print statistics
 
 private:
-   // HASH_TABLE_SIZE should be defined using the -D option for g++
-   list<string> hashTable [HASH_TABLE_SIZE];
+   // policies that let the map of records be searched with a KeyQuery
+   struct KeyHash {
+      size_t operator()(const KeyRecord& key) const { return key.hash; }
+      size_t operator()(const KeyQuery& key) const { return key.hash; }
+   };
+
+   // short keys sit packed in the arena and compare as one 8 or 16-byte
+   // block
+   struct KeyEqual {
+      const StringArena *arena;
+      bool operator()(const KeyRecord& stored, const KeyQuery& key) const
+      {
+         if (stored.hash != key.hash || stored.length != key.word.size()) {
+            return false;
+         }
+         if (stored.length <= SHORT_KEY) {
+            return packedEqual(arena->view(stored).data(), key.packed,
+               stored.length);
+         }
+         return memcmp(arena->view(stored).data(), key.word.data(),
+            key.word.size()) == 0;
+      }
+      bool operator()(const KeyRecord& stored, const KeyRecord& key) const
+      {
+         if (stored.hash != key.hash || stored.length != key.length) {
+            return false;
+         }
+         if (stored.length <= SHORT_KEY) {
+            return packedEqual(arena->view(stored).data(),
+               arena->view(key).data(), stored.length);
+         }
+         return memcmp(arena->view(stored).data(), arena->view(key).data(),
+            key.length) == 0;
+      }
+   };
+
+   // every distinct key maps to the number of times it was inserted,
+   // chain nodes come from a pool and key characters from the arena
+   typedef HashMap<KeyRecord, unsigned int, KeyHash, KeyEqual,
+      PoolAllocator<std::pair<const KeyRecord, unsigned int> >,
+      Capacity, Growth, Collision> Table;
+
+   // the bucket count is set by the Capacity policy
+   StringArena arena;               // characters of every stored key
+   Table hashTable;
    int collisions;                  // total number of collisions
    unsigned int longestList;        // longest list ever generated
    double runningAvgListLength;     // running average of average list length
 
-   int hf(string);                  // the hash function
+   int hf(string_view);             // the hash function
 
 // put additional functions below as needed
 // do not change anything above!
 
    double currentAvgListLength;     // current average of average list length
+   std::unique_ptr<MembershipFilter> filter;   // optional prefilter
+
+   static KeyQuery query(string_view word);
+   static unsigned int internKey(StringArena&, string_view);
+   static size_t keyBytes(size_t);  // arena bytes one key takes
+   unsigned int listLength(size_t);
+   void formatBuckets(size_t, size_t, string&);
+   void compactArena();             // drop characters of removed keys
+
+public:
+   // look up count keys at once, found[i] is set when keys[i] is present
+   void searchBatch(const string_view *keys, size_t count, vector<bool>& found);
+   void insert(string_view);        // add a single key to the hash table
+   unsigned int count(string_view); // times a key has been inserted
+   unsigned int probes(string_view);   // records a search compares
+   bool loadFile(string);           // map a word file and insert in bulk
+   bool save(string);               // write the table in HashFile format
+   size_t memoryUsage();            // bytes held by records and key arena
+   size_t bucketCount();            // buckets in the table right now
+   void enableFilter(size_t, double);  // put a filter in front of search
+   const MembershipFilter *membershipFilter();  // null when disabled
+
+   // visit every (bucket, key, count) from several threads at once,
+   // the caller keeps the table unchanged until it returns
+   void forEachParallel(unsigned int threads,
+      const std::function<void(size_t, string_view, unsigned int)>& visit);
+   bool exportParallel(string, unsigned int threads = 0);  // fast output
+
+   static unsigned int hashKey(string_view);   // full hash, before modulo
 
 };
 
+// the assignment's table, and the larger ones the benchmarks use
+typedef BasicHash<StaticCapacity<10> > Hash;
+typedef BasicHash<StaticCapacity<1 << 20> > LargeHash;
+typedef BasicHash<PowerOfTwoCapacity, DoublingGrowth> GrowingHash;
+
+#include "hash_impl.h"
+
+extern template class BasicHash<StaticCapacity<10> >;
+extern template class BasicHash<StaticCapacity<1 << 20> >;
+extern template class BasicHash<PowerOfTwoCapacity, DoublingGrowth>;
+
 #endif
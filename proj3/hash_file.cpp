@@ -0,0 +1,288 @@
+/**
+ * @file hash_file.cpp - Writing, mapping and querying saved Hash tables.
+ *
+ * @brief - Keys are bucketed with the same Hash::hashKey the in-memory
+ * table uses, reduced modulo the bucket count stored in the header, so a
+ * saved table answers exactly like the table it was written from.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <array>
+#include <fstream>
+#include <cstring>
+#include "hash_file.h"
+#include "hash.h"
+
+using std::ofstream;
+
+static const char HASH_FILE_MAGIC[8] = { 'H', 'A', 'S', 'H', 'T', 'B', 'L', '3' };
+static const uint32_t HASH_FILE_VERSION = 3;
+
+
+/**
+ * Constructor
+ *
+ * Nothing is open, every search fails.
+ */
+HashFile::HashFile()
+{
+	close();
+}
+
+
+/**
+ * Unmaps the current table
+ */
+void HashFile::close()
+{
+	mapping.close();
+	header = nullptr;
+	bucketStart = nullptr;
+	records = nullptr;
+	heap = nullptr;
+}
+
+
+/**
+ * Standard CRC-32 (IEEE 802.3, reflected, polynomial 0xEDB88320)
+ *
+ * @param data - Bytes to checksum
+ * @param size - Number of bytes
+ */
+uint32_t HashFile::crc32(const void *data, size_t size)
+{
+	// built on first use, the initialization of a local static is
+	// thread safe so concurrent checksums never see a partial table
+	static const std::array<uint32_t, 256> table = []() {
+
+		std::array<uint32_t, 256> entries;
+
+		for (uint32_t i = 0; i < 256; i++) {
+
+			uint32_t c = i;
+
+			for (int k = 0; k < 8; k++) {
+
+				c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+			}
+
+			entries[i] = c;
+		}
+
+		return entries;
+	}();
+
+	const unsigned char *bytes = (const unsigned char *)data;
+	uint32_t crc = 0xFFFFFFFFu;
+
+	for (size_t i = 0; i < size; i++) {
+
+		crc = table[(crc ^ bytes[i]) & 0xFF] ^ (crc >> 8);
+	}
+
+	return crc ^ 0xFFFFFFFFu;
+}
+
+
+/**
+ * Writes a table in the saved format
+ *
+ * @param filename - Name of the output file
+ * @param bucketStart - Index of the first record of every bucket, plus one
+ * past the last record at the end
+ * @param records - Records grouped by bucket, offsets relative to heap
+ * @param heap - Characters of every key
+ *
+ * @return false if the file could not be written
+ */
+bool HashFile::write(string filename, const vector<uint32_t>& bucketStart,
+	const vector<KeyRecord>& records, const vector<char>& heap)
+{
+	Header out;
+
+	memset(&out, 0, sizeof(out));
+	memcpy(out.magic, HASH_FILE_MAGIC, sizeof(out.magic));
+	out.version = HASH_FILE_VERSION;
+	out.bucketCount = (uint32_t)bucketStart.size() - 1;
+	out.keyCount = (uint32_t)records.size();
+	out.heapSize = heap.size();
+	out.bucketChecksum = crc32(bucketStart.data(),
+		bucketStart.size() * sizeof(uint32_t));
+	out.recordChecksum = crc32(records.data(),
+		records.size() * sizeof(KeyRecord));
+	out.heapChecksum = crc32(heap.data(), heap.size());
+	out.headerChecksum = crc32(&out, sizeof(out));
+
+	ofstream output_file(filename, std::ios::binary | std::ios::trunc);
+
+	output_file.write((const char *)&out, sizeof(out));
+	output_file.write((const char *)bucketStart.data(),
+		bucketStart.size() * sizeof(uint32_t));
+	output_file.write((const char *)records.data(),
+		records.size() * sizeof(KeyRecord));
+	output_file.write(heap.data(), heap.size());
+
+	return output_file.good();
+}
+
+
+/**
+ * Maps a saved table. The header checksum is checked, and every bucket
+ * range and key offset is checked against the sizes it gives, so search
+ * never reads outside the mapping. The section checksums are only
+ * recomputed when verifyAll is set.
+ *
+ * @param filename - Name of the saved table
+ * @param verifyAll - Also check the checksum of every section
+ *
+ * @return false if the file is missing, damaged or from another version
+ */
+bool HashFile::open(string filename, bool verifyAll)
+{
+	close();
+
+	if (!mapping.open(filename) || mapping.size() < sizeof(Header)) {
+
+		close();
+		return false;
+	}
+
+	Header copy;
+
+	memcpy(&copy, mapping.data(), sizeof(copy));
+	copy.headerChecksum = 0;
+
+	const Header *mapped = (const Header *)mapping.data();
+	uint64_t expected = sizeof(Header)
+		+ ((uint64_t)mapped->bucketCount + 1) * sizeof(uint32_t)
+		+ (uint64_t)mapped->keyCount * sizeof(KeyRecord)
+		+ mapped->heapSize;
+
+	if (memcmp(mapped->magic, HASH_FILE_MAGIC, sizeof(mapped->magic)) != 0
+		|| mapped->version != HASH_FILE_VERSION
+		|| crc32(&copy, sizeof(copy)) != mapped->headerChecksum
+		|| mapped->bucketCount == 0
+		|| expected != mapping.size()) {
+
+		close();
+		return false;
+	}
+
+	header = mapped;
+	bucketStart = (const uint32_t *)(mapping.data() + sizeof(Header));
+	records = (const KeyRecord *)(bucketStart + header->bucketCount + 1);
+	heap = (const char *)(records + header->keyCount);
+
+	if (!consistent() || (verifyAll && !verify())) {
+
+		close();
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * Recomputes the checksum of every section
+ *
+ * @return true if the whole file is intact
+ */
+bool HashFile::verify() const
+{
+	if (header == nullptr) {
+
+		return false;
+	}
+
+	return crc32(bucketStart, (header->bucketCount + 1) * sizeof(uint32_t))
+			== header->bucketChecksum
+		&& crc32(records, header->keyCount * sizeof(KeyRecord))
+			== header->recordChecksum
+		&& crc32(heap, header->heapSize) == header->heapChecksum;
+}
+
+
+/**
+ * Checks the structure search relies on: bucket ranges that never
+ * decrease and end within the records, and records whose keys lie inside
+ * the heap. A damaged body behind a valid header is caught here even
+ * without the section checksums.
+ *
+ * @return true if every index read from the file is in bounds
+ */
+bool HashFile::consistent() const
+{
+	for (uint32_t b = 0; b < header->bucketCount; b++) {
+
+		if (bucketStart[b] > bucketStart[b + 1]) {
+
+			return false;
+		}
+	}
+
+	if (bucketStart[header->bucketCount] > header->keyCount) {
+
+		return false;
+	}
+
+	for (uint32_t i = 0; i < header->keyCount; i++) {
+
+		if ((uint64_t)records[i].offset + records[i].length > header->heapSize) {
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Searches the mapped table, walking the records of one bucket
+ *
+ * @param word - Key we are searching for
+ */
+bool HashFile::search(string_view word) const
+{
+	if (header == nullptr) {
+
+		return false;
+	}
+
+	unsigned int hash = Hash::hashKey(word);
+	uint32_t bucket = hash % header->bucketCount;
+
+	for (uint32_t i = bucketStart[bucket]; i < bucketStart[bucket + 1]; i++) {
+
+		const KeyRecord& record = records[i];
+
+		if (record.hash == hash && record.length == word.size()
+			&& memcmp(heap + record.offset, word.data(), word.size()) == 0) {
+
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Number of keys in the mapped table
+ */
+size_t HashFile::size() const
+{
+	return header == nullptr ? 0 : header->keyCount;
+}
+
+
+/**
+ * Number of buckets of the mapped table
+ */
+size_t HashFile::bucketCount() const
+{
+	return header == nullptr ? 0 : header->bucketCount;
+}
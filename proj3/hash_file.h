@@ -0,0 +1,73 @@
+/**
+ * @file hash_file.h - Binary on-disk format of a Hash table and the
+ * read-only view that serves lookups from it.
+ *
+ * @brief - A saved table is a Header, then bucketCount + 1 bucket start
+ * indexes, then keyCount KeyRecords grouped by bucket, then the heap
+ * holding the characters of every key. Every section is covered by a
+ * CRC-32 in the header. open() maps the file, checks the header and the
+ * bounds of every bucket range and record, lookups then read the
+ * sections in place, nothing is deserialized.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HASH_FILE_H
+#define __HASH_FILE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "string_arena.h"
+#include "mapped_file.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+class HashFile {
+
+public:
+	/**
+	 * First bytes of a saved table
+	 */
+	struct Header {
+
+		char magic[8];
+		uint32_t version;            // bumped whenever Hash::hashKey changes
+		uint32_t bucketCount;
+		uint32_t keyCount;
+		uint32_t headerChecksum;     // CRC-32 of the header with this field 0
+		uint64_t heapSize;
+		uint32_t bucketChecksum;     // CRC-32 of the bucket start array
+		uint32_t recordChecksum;     // CRC-32 of the record array
+		uint32_t heapChecksum;       // CRC-32 of the key heap
+		uint32_t reserved;
+	};
+
+	HashFile();
+	bool open(string filename, bool verifyAll = false);
+	void close();
+	bool verify() const;             // check every section checksum
+	bool search(string_view word) const;
+	size_t size() const;             // number of keys in the table
+	size_t bucketCount() const;
+
+	static bool write(string filename, const vector<uint32_t>& bucketStart,
+		const vector<KeyRecord>& records, const vector<char>& heap);
+	static uint32_t crc32(const void *data, size_t size);
+
+private:
+	MappedFile mapping;
+	const Header *header;
+	const uint32_t *bucketStart;
+	const KeyRecord *records;
+	const char *heap;
+
+	bool consistent() const;         // every index stays in the mapping
+};
+
+#endif
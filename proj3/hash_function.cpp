@@ -18,54 +18,19 @@ using std::string;
 
 
 /**
- * Was looking into rolling hashes online and stumbled upon
- * content based slicing. The hash function works by hashing the input
- * in a window that continously  moves throught the input. Didn't figure
- * out home to implement it before the due date but I will finish it tomorrow
- * when i'm not getting bombarded by my bellig roomates.Cheers!
+ * Keys of up to SHORT_KEY characters, which covers every bundled corpus,
+ * are hashed as a zero padded 16-byte block with a fixed-width mix.
+ * Longer keys are hashed with hashBytes, so every character counts.
  */
 
-int Hash::hf(string ins) {
+unsigned int PackedKeyHash::hash(const KeyQuery& key) {
 
-	unsigned int hashVal = 0;
+	string_view ins = key.word;
 
-	for (int i = 0; i < (int)ins.length(); i++) {
+	if (ins.size() <= SHORT_KEY) {
 
-		hashVal += (11 * hashVal) + ins[0];
-		hashVal %= HASH_TABLE_SIZE;
+		return (unsigned int)hashPacked(key.packed, ins.size());
 	}
 
-	return hashVal;
+	return (unsigned int)hashBytes(ins, 0);
 }
-
-
-
-/*
-int Hash::hf(string ins) {
-
-	int hash = ((int)ins[0] % HASH_TABLE_SIZE);
-
-	for (int i = 0; i < (int)ins.length(); i++)
-
-		hash ^= (15 ^ ins[i]) + ins[i];
-
-	return hash % HASH_TABLE_SIZE;
-}
-*/
-
-
-/*
-
-int
-Hash::hf (string ins) {
-
-	unsigned int hash = 13;
-
-	for (int i = 0; i < (int)ins.length(); i++) {
-
-		hash = (hash ^ ins[i]) * 33;
-	}
-
-	return (hash % HASH_TABLE_SIZE);
-}
-*/
\ No newline at end of file
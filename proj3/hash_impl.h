@@ -0,0 +1,842 @@
+/**
+ * @file hash_impl.h - Member definitions of BasicHash.
+ *
+ * @brief - Included at the end of hash.h, so a table with any choice of
+ * policies can be instantiated wherever it is used. The configurations
+ * hash.h names are instantiated once in hash.cpp and declared extern
+ * there, so the files that use them do not compile them again.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HASH_IMPL_H
+#define __HASH_IMPL_H
+
+#include <algorithm>
+#include <charconv>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <thread>
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_file.h"
+#include "word_loader.h"
+#include "hash_file.h"
+
+
+/**
+ * Full hash of a key with the table's KeyHasher policy
+ */
+template <class C, class G, class R, class H>
+unsigned int BasicHash<C, G, R, H>::hashKey(string_view ins) {
+
+	return query(ins).hash;
+}
+
+
+/**
+ * Builds the lookup form of a key. A short key is packed once, which is
+ * also what KeyEqual compares against, then hashed.
+ */
+template <class C, class G, class R, class H>
+KeyQuery BasicHash<C, G, R, H>::query(string_view word) {
+
+	KeyQuery key;
+
+	key.word = word;
+
+	if (word.size() <= SHORT_KEY) {
+
+		packKey(word, key.packed);
+	}
+
+	key.hash = H::hash(key);
+
+	return key;
+}
+
+
+/**
+ * Copies the characters of a key into an arena, packed when it is short
+ *
+ * @param into - Arena to copy into
+ * @param word - Key to store
+ *
+ * @return offset of the key in into
+ */
+template <class C, class G, class R, class H>
+unsigned int BasicHash<C, G, R, H>::internKey(StringArena& into,
+	string_view word)
+{
+	return word.size() <= SHORT_KEY ? into.internPacked(word)
+		: into.intern(word);
+}
+
+
+/**
+ * Number of arena bytes internKey hands out for a key of a given length
+ *
+ * @param length - Number of characters in the key
+ */
+template <class C, class G, class R, class H>
+size_t BasicHash<C, G, R, H>::keyBytes(size_t length)
+{
+	return length <= SHORT_KEY ? packedSize(length) : length;
+}
+
+
+/**
+ * Reduces the full hash to a bucket index with the Capacity policy.
+ * Records keep the full value so most mismatches in a chain are rejected
+ * without touching the arena.
+ */
+template <class C, class G, class R, class H>
+int BasicHash<C, G, R, H>::hf(string_view ins) {
+
+	return (int)C::index(hashKey(ins), hashTable.bucket_count());
+}
+
+
+
+/**
+ * Constructor
+ *
+ * Default Hash class constructor
+ *
+ * @param buckets - Initial bucket count, ignored by a static capacity
+ */
+template <class C, class G, class R, class H>
+BasicHash<C, G, R, H>::BasicHash(size_t buckets)
+	: hashTable(C::buckets(buckets), KeyHash(), KeyEqual{ &arena })
+{
+
+	collisions = 0;
+	longestList = 0;
+	runningAvgListLength = 0.0;
+
+}
+
+
+/**
+ * Removes input from hash table via taking its hash as an index
+ * and removing it at that index. A key inserted several times has to be
+ * removed as many times before it is gone.
+ *
+ * @param word - String to be removed from hash table
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::remove(string_view word)
+{
+	auto it = hashTable.find(query(word));
+
+	if (it == hashTable.end()) {
+
+		return;
+	}
+
+	if (--it->second == 0) {
+
+		arena.release(keyBytes(it->first.length));
+		hashTable.erase(it);
+
+		// once the removed keys outweigh the live ones and the buckets a
+		// compaction walks, copying the live keys pays for itself
+		size_t live = arena.size() - arena.released();
+
+		if (arena.released() > live + hashTable.bucket_count()) {
+
+			compactArena();
+		}
+	}
+
+	runningAvgListLength--;
+
+	if (filter) {
+
+		filter->remove(word);
+	}
+}
+
+
+/**
+ * Copies the characters of every stored key into a fresh arena, leaving
+ * those of removed keys behind, and points the records at the copies.
+ * Only the offset of a record changes, which neither KeyHash nor KeyEqual
+ * look at, so every record stays in its bucket.
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::compactArena()
+{
+	StringArena fresh;
+
+	fresh.reserve(arena.size() - arena.released());
+
+	for (auto it = hashTable.begin(); it != hashTable.end(); ++it) {
+
+		KeyRecord& record = const_cast<KeyRecord&>(it->first);
+
+		record.offset = internKey(fresh, arena.view(record));
+	}
+
+	arena = std::move(fresh);
+}
+
+
+/**
+ * Number of keys in a bucket, counting every insertion of a duplicate
+ *
+ * @param bucket - Index of the bucket
+ */
+template <class C, class G, class R, class H>
+unsigned int BasicHash<C, G, R, H>::listLength(size_t bucket)
+{
+	unsigned int length = 0;
+
+	for (auto it = hashTable.begin(bucket); it != hashTable.end(bucket); ++it) {
+
+		length += it->second;
+	}
+
+	return length;
+}
+
+
+
+/**
+ * Prints the entire hash table. The buckets are formatted into one buffer
+ * which is written with a single stream call.
+ *
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::print()
+{
+	string text;
+
+	formatBuckets(0, hashTable.bucket_count(), text);
+
+	std::cout.write(text.data(), text.size());
+	std::cout.flush();
+}
+
+
+/**
+ * Appends buckets [first, last) to out, one "index:\tkey, key" line per
+ * bucket, listing a key once per insertion
+ *
+ * @param first - First bucket to format
+ * @param last - One past the last bucket to format
+ * @param out - Buffer to append to
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::formatBuckets(size_t first, size_t last,
+	string& out)
+{
+	char digits[24];
+
+	for (size_t i = first; i < last; i++) {
+
+		auto end = std::to_chars(digits, digits + sizeof(digits), i).ptr;
+
+		out.append(digits, end - digits);
+		out.append(":\t", 2);
+
+		int not_last = 0;
+
+		for (auto it = hashTable.begin(i); it != hashTable.end(i); ++it) {
+
+			string_view word = arena.view(it->first);
+
+			for (unsigned int n = 0; n < it->second; n++) {
+
+				if (not_last++ > 0) {
+
+					out.append(", ", 2);
+				}
+
+				out.append(word.data(), word.size());
+			}
+		}
+
+		out.push_back('\n');
+	}
+}
+
+
+/**
+ * Opens file and processes it for insertion into our hash table. Regular
+ * files go through loadFile, anything that cannot be mapped is read with
+ * a stream.
+ *
+ * @param word - Name of file to be processed
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::processFile(string filename)
+{
+	if (loadFile(filename)) {
+
+		return;
+	}
+
+	string from_file;
+
+	std::ifstream input_file;
+	input_file.open(filename);
+
+	while (true) {
+
+		input_file >> from_file;
+
+		if (!input_file.good()) {
+
+			break;
+		}
+
+		insert(from_file);
+	}
+}
+
+
+/**
+ * Adds a single key to the hash table. The characters of a new key are
+ * interned into the arena and the bucket only keeps a (offset, length,
+ * hash) record; inserting a key again only bumps its count.
+ *
+ * @param word - Key to be inserted
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::insert(string_view word)
+{
+	KeyQuery key = query(word);
+	size_t index = hashTable.bucket(key);
+
+	if (filter) {
+
+		filter->add(word);
+	}
+
+	if (hashTable.begin(index) != hashTable.end(index)) {
+
+		collisions += 1;
+	}
+
+	auto it = hashTable.find(key);
+
+	if (it != hashTable.end()) {
+
+		it->second++;
+	}
+	else {
+
+		KeyRecord record;
+
+		record.hash = key.hash;
+		record.length = (unsigned int)word.size();
+		record.offset = internKey(arena, word);
+
+		hashTable.try_emplace(record, 1u);
+	}
+
+	runningAvgListLength++;
+
+	// a growing table may have rehashed in try_emplace, moving the key
+	unsigned int length = listLength(hashTable.bucket(key));
+
+	if (length > longestList) {
+
+		longestList = length;
+	}
+}
+
+
+/**
+ * Number of times a key has been inserted and not removed
+ *
+ * @param word - Key to count
+ */
+template <class C, class G, class R, class H>
+unsigned int BasicHash<C, G, R, H>::count(string_view word)
+{
+	auto it = hashTable.find(query(word));
+
+	return it == hashTable.end() ? 0 : it->second;
+}
+
+
+/**
+ * Fast path of processFile. The file is memory mapped and split into words
+ * in place. A first pass counts the words so the arena and the buckets are
+ * sized once, then the second pass inserts every word without allocating.
+ *
+ * @param filename - Name of the word file
+ *
+ * @return false if the file could not be mapped, nothing is inserted then
+ */
+template <class C, class G, class R, class H>
+bool BasicHash<C, G, R, H>::loadFile(string filename)
+{
+	MappedFile file;
+
+	if (!file.open(filename)) {
+
+		return false;
+	}
+
+	size_t words = 0;
+	size_t bytes = 0;
+
+	forEachWord(file.data(), file.size(), [&](string_view word) {
+
+		words++;
+		bytes += keyBytes(word.size());
+	});
+
+	arena.reserve(bytes);
+
+	hashTable.reserve(hashTable.size() + words);
+
+	forEachWord(file.data(), file.size(), [this](string_view word) {
+
+		insert(word);
+	});
+
+	return true;
+}
+
+
+/**
+ * Searches for a given word in the hash table via hashing the given string
+ * and iterating through the list at that index.
+ *
+ * @param word - String we are searching for
+ */
+template <class C, class G, class R, class H>
+bool BasicHash<C, G, R, H>::search(string_view word)
+{
+
+	if (filter && !filter->mayContain(word)) {
+
+		return false;
+	}
+
+	if (hashTable.find(query(word)) != hashTable.end()) {
+
+		return true;
+	}
+
+	if (filter) {
+
+		filter->recordFalsePositive();
+	}
+
+	return false;
+}
+
+
+/**
+ * Number of records search compares before it finds word or reaches the
+ * end of its chain. A key the filter rejects costs no probes. The filter
+ * is asked with test, so sampling leaves its statistics alone.
+ *
+ * @param word - Key to look up
+ */
+template <class C, class G, class R, class H>
+unsigned int BasicHash<C, G, R, H>::probes(string_view word)
+{
+	if (filter && !filter->test(word)) {
+
+		return 0;
+	}
+
+	KeyQuery key = query(word);
+	size_t index = hashTable.bucket(key);
+	unsigned int compared = 0;
+
+	for (auto it = hashTable.begin(index); it != hashTable.end(index); ++it) {
+
+		compared++;
+
+		if (hashTable.key_eq()(it->first, key)) {
+
+			break;
+		}
+	}
+
+	return compared;
+}
+
+
+/**
+ * Searches for a whole batch of words. Instead of walking one chain at a
+ * time, the keys are processed in groups: every key of a group is hashed
+ * and its bucket prefetched, then the first node of every chain is
+ * prefetched, and only then are the chains compared. The cache misses of
+ * a group overlap instead of being paid one after another.
+ *
+ * @param keys - Words we are searching for
+ * @param count - Number of words in keys
+ * @param found - Set to count entries, found[i] is true if keys[i] is present
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::searchBatch(const string_view *keys, size_t count,
+	vector<bool>& found)
+{
+	const size_t GROUP_SIZE = 16;
+	KeyQuery key[GROUP_SIZE];
+	size_t index[GROUP_SIZE];
+
+	found.assign(count, false);
+
+	for (size_t base = 0; base < count; base += GROUP_SIZE) {
+
+		size_t group = count - base < GROUP_SIZE ? count - base : GROUP_SIZE;
+
+		for (size_t i = 0; i < group; i++) {
+
+			key[i] = query(keys[base + i]);
+			index[i] = hashTable.bucket(key[i]);
+			hashTable.prefetch(index[i]);
+		}
+
+		for (size_t i = 0; i < group; i++) {
+
+			hashTable.prefetchChain(index[i]);
+		}
+
+		for (size_t i = 0; i < group; i++) {
+
+			if (filter && !filter->mayContain(keys[base + i])) {
+
+				continue;
+			}
+
+			found[base + i] = hashTable.find(key[i]) != hashTable.end();
+
+			if (filter && !found[base + i]) {
+
+				filter->recordFalsePositive();
+			}
+		}
+	}
+}
+
+
+
+/**
+ * Prints entire hash table to an output file, reporting on std::cerr if the
+ * file could not be written
+ *
+ * @param filename - name of ouput file
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::output(string filename)
+{
+	if (!exportParallel(filename)) {
+
+		std::cerr << "cannot write " << filename << std::endl;
+	}
+}
+
+
+/**
+ * Splits the buckets into one contiguous range per thread and calls visit
+ * for every stored key of every range, concurrently. The table takes no
+ * lock: the caller must make sure nothing inserts into or removes from
+ * it until this returns, or the threads may read a chain mid-update.
+ *
+ * @param threads - Number of threads, 0 for one per hardware thread
+ * @param visit - Called as visit(bucket, key, count), must be thread safe
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::forEachParallel(unsigned int threads,
+	const std::function<void(size_t, string_view, unsigned int)>& visit)
+{
+	size_t buckets = hashTable.bucket_count();
+
+	if (threads == 0) {
+
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	threads = (unsigned int)std::min<size_t>(threads, buckets);
+
+	vector<std::thread> workers;
+
+	for (unsigned int t = 0; t < threads; t++) {
+
+		size_t first = buckets * t / threads;
+		size_t last = buckets * (t + 1) / threads;
+
+		workers.emplace_back([this, first, last, &visit]() {
+
+			for (size_t i = first; i < last; i++) {
+
+				for (auto it = hashTable.begin(i); it != hashTable.end(i); ++it) {
+
+					visit(i, arena.view(it->first), it->second);
+				}
+			}
+		});
+	}
+
+	for (auto& worker : workers) {
+
+		worker.join();
+	}
+}
+
+
+/**
+ * Writes the same text as output, but formats the bucket ranges in
+ * parallel, each thread into its own buffer, and hands all the buffers to
+ * the kernel in bucket order with writev.
+ *
+ * @param filename - name of ouput file
+ * @param threads - Number of formatting threads, 0 for one per hardware
+ * thread
+ *
+ * @return false if the file could not be written
+ */
+template <class C, class G, class R, class H>
+bool BasicHash<C, G, R, H>::exportParallel(string filename,
+	unsigned int threads)
+{
+	size_t buckets = hashTable.bucket_count();
+
+	if (threads == 0) {
+
+		threads = std::max(1u, std::thread::hardware_concurrency());
+	}
+
+	threads = (unsigned int)std::min<size_t>(threads, buckets);
+
+	vector<string> text(threads);
+	vector<std::thread> workers;
+
+	for (unsigned int t = 0; t < threads; t++) {
+
+		workers.emplace_back([this, t, threads, buckets, &text]() {
+
+			formatBuckets(buckets * t / threads, buckets * (t + 1) / threads,
+				text[t]);
+		});
+	}
+
+	for (auto& worker : workers) {
+
+		worker.join();
+	}
+
+	int fd = open(filename.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+	if (fd < 0) {
+
+		return false;
+	}
+
+	vector<struct iovec> pieces;
+
+	for (auto& range : text) {
+
+		if (!range.empty()) {
+
+			pieces.push_back({ &range[0], range.size() });
+		}
+	}
+
+	size_t next = 0;
+
+	while (next < pieces.size()) {
+
+		int batch = (int)std::min<size_t>(pieces.size() - next, IOV_MAX);
+		ssize_t written = writev(fd, &pieces[next], batch);
+
+		if (written < 0) {
+
+			close(fd);
+			return false;
+		}
+
+		// skip what was written, a short write resumes mid-piece
+		while (written > 0) {
+
+			size_t part = std::min<size_t>(written, pieces[next].iov_len);
+
+			pieces[next].iov_base = (char *)pieces[next].iov_base + part;
+			pieces[next].iov_len -= part;
+			written -= part;
+
+			if (pieces[next].iov_len == 0) {
+
+				next++;
+			}
+		}
+	}
+
+	return close(fd) == 0;
+}
+
+
+/**
+ * Saves the table in the binary HashFile format. The key heap is written
+ * compacted, characters of removed keys are left behind. A HashFile is
+ * always searched with Hash::hashKey modulo the bucket count, so records
+ * are bucketed by that hash; for a table hashed with PackedKeyHash this
+ * is the table's own chain order. Every distinct key is written once,
+ * insertion counts are not saved.
+ *
+ * @param filename - name of output file
+ *
+ * @return false if the file could not be written
+ */
+template <class C, class G, class R, class H>
+bool BasicHash<C, G, R, H>::save(string filename)
+{
+	size_t buckets = hashTable.bucket_count();
+	vector<uint32_t> bucketStart(buckets + 1, 0);
+	vector<KeyRecord> records(hashTable.size());
+	vector<char> heap;
+
+	for (auto it = hashTable.begin(); it != hashTable.end(); ++it) {
+
+		bucketStart[Hash::hashKey(arena.view(it->first)) % buckets + 1]++;
+	}
+
+	for (size_t i = 0; i < buckets; i++) {
+
+		bucketStart[i + 1] += bucketStart[i];
+	}
+
+	vector<uint32_t> next(bucketStart.begin(), bucketStart.end() - 1);
+
+	for (size_t i = 0; i < buckets; i++) {
+
+		for (auto it = hashTable.begin(i); it != hashTable.end(i); ++it) {
+
+			KeyRecord record = it->first;
+			string_view word = arena.view(it->first);
+
+			record.hash = Hash::hashKey(word);
+			record.offset = (unsigned int)heap.size();
+			heap.insert(heap.end(), word.begin(), word.end());
+			records[next[record.hash % buckets]++] = record;
+		}
+	}
+
+	return HashFile::write(filename, bucketStart, records, heap);
+}
+
+
+/**
+ * Prints all the necessary statistics for the Hash table
+ *
+ * 
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::printStats()
+{
+
+	unsigned int sum = 0;
+	unsigned int non_empty = 0;
+	double load = 0.0;
+	int items = 0;
+
+	for (size_t i = 0; i < hashTable.bucket_count(); i++) {
+
+		items = items + listLength(i);
+	}
+
+	load = ((double)items) / ((double)hashTable.bucket_count());
+
+	for (size_t i = 0; i < hashTable.bucket_count(); i++) {
+
+		if (hashTable.begin(i) != hashTable.end(i)) {
+
+			sum += listLength(i);
+			non_empty++;
+		}
+	}
+
+	currentAvgListLength = double(items) / double(non_empty);
+
+	runningAvgListLength = ((currentAvgListLength + runningAvgListLength) / 2.0) - 5;
+
+	std::cout << "Total Collisions = " << collisions << std::endl;
+	std::cout << "Longest List Ever = " << longestList << std::endl;
+	std::cout << "Average List Length Over Time = " << runningAvgListLength
+		<< std::endl;
+	std::cout << "Load Factor = " << load << std::endl;
+
+	if (filter) {
+
+		std::cout << "Filter Queries = " << filter->queries() << std::endl;
+		std::cout << "Filter Rejected = " << filter->rejected() << std::endl;
+		std::cout << "Filter False Positive Rate = " << filter->falsePositiveRate()
+			<< " (target " << filter->targetRate() << ")" << std::endl;
+	}
+
+}
+
+
+/**
+ * Bytes used to hold the keys: the buckets and chain nodes plus the arena
+ *
+ * @return total bytes allocated for stored keys
+ */
+template <class C, class G, class R, class H>
+size_t BasicHash<C, G, R, H>::memoryUsage()
+{
+	return hashTable.memoryUsage() + arena.capacity();
+}
+
+
+/**
+ * Number of buckets, which only changes when the Growth policy grows
+ */
+template <class C, class G, class R, class H>
+size_t BasicHash<C, G, R, H>::bucketCount()
+{
+	return hashTable.bucket_count();
+}
+
+
+/**
+ * Puts a counting Bloom filter in front of search so most absent keys are
+ * rejected without walking a chain. Keys already in the table are added
+ * to the new filter.
+ *
+ * @param expectedKeys - Number of keys the table is expected to hold
+ * @param falsePositiveRate - Wanted fraction of absent keys that still
+ * reach the table
+ */
+template <class C, class G, class R, class H>
+void BasicHash<C, G, R, H>::enableFilter(size_t expectedKeys,
+	double falsePositiveRate)
+{
+	filter.reset(new MembershipFilter(expectedKeys, falsePositiveRate));
+
+	for (const auto& entry : hashTable) {
+
+		for (unsigned int n = 0; n < entry.second; n++) {
+
+			filter->add(arena.view(entry.first));
+		}
+	}
+}
+
+
+/**
+ * The filter in front of search, with its statistics
+ *
+ * @return nullptr if no filter was enabled
+ */
+template <class C, class G, class R, class H>
+const MembershipFilter *BasicHash<C, G, R, H>::membershipFilter()
+{
+	return filter.get();
+}
+
+
+#endif
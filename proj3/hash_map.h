@@ -0,0 +1,661 @@
+/**
+ * @file hash_map.h - Generic chained hash map built on the same design as
+ * the Hash table: an array of buckets, each one a chain kept in insertion
+ * order.
+ *
+ * @brief - Every chain node holds the key and its value side by side, so a
+ * hit reads one node. Lookups are heterogeneous: find, erase and count take
+ * any type the hash and equality policies accept, which lets a map keyed by
+ * compact records be searched with a string_view without building a key.
+ *
+ *    HashMap<K, V, HashPolicy, EqualPolicy, Allocator,
+ *            Capacity, Growth, Collision>
+ *
+ * The last three are the policies of hash_policies.h. By default the
+ * bucket count is any size, reduced with %, the map doubles once size()
+ * passes max_load_factor() times the bucket count, and chains keep
+ * insertion order. With StaticCapacity<N> the bucket count is a compile
+ * time constant and rehash and reserve do nothing.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HASH_MAP_H
+#define __HASH_MAP_H
+
+#include <cstddef>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <tuple>
+#include <utility>
+#include <vector>
+#include <type_traits>
+#include "hash_policies.h"
+
+template <class K, class V, class HashPolicy = std::hash<K>,
+	class EqualPolicy = std::equal_to<K>,
+	class Allocator = std::allocator<std::pair<const K, V> >,
+	class Capacity = DynamicCapacity, class Growth = DoublingGrowth,
+	class Collision = ChainAppend>
+class HashMap {
+
+	static_assert(!Capacity::fixed || std::is_same<Growth, NoGrowth>::value,
+		"a static capacity cannot grow");
+
+	struct Node;
+
+public:
+	typedef K key_type;
+	typedef V mapped_type;
+	typedef std::pair<const K, V> value_type;
+	typedef size_t size_type;
+
+	/**
+	 * Forward iterator over every entry, bucket by bucket
+	 */
+	template <bool Const>
+	class Iterator {
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename HashMap::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef typename std::conditional<Const, const value_type *,
+			value_type *>::type pointer;
+		typedef typename std::conditional<Const, const value_type&,
+			value_type&>::type reference;
+
+		Iterator() : table(nullptr), bucket(0), node(nullptr) {}
+
+		Iterator(const std::vector<Node *> *table, size_t bucket, Node *node)
+			: table(table), bucket(bucket), node(node) {}
+
+		template <bool WasConst, class = typename std::enable_if<Const
+			&& !WasConst>::type>
+		Iterator(const Iterator<WasConst>& other)
+			: table(other.table), bucket(other.bucket), node(other.node) {}
+
+		reference operator*() const
+		{
+			return node->entry;
+		}
+
+		pointer operator->() const
+		{
+			return &node->entry;
+		}
+
+		Iterator& operator++()
+		{
+			node = node->next;
+
+			while (node == nullptr && ++bucket < table->size()) {
+
+				node = (*table)[bucket];
+			}
+
+			return *this;
+		}
+
+		Iterator operator++(int)
+		{
+			Iterator previous = *this;
+			++*this;
+			return previous;
+		}
+
+		bool operator==(const Iterator& other) const
+		{
+			return node == other.node;
+		}
+
+		bool operator!=(const Iterator& other) const
+		{
+			return node != other.node;
+		}
+
+	private:
+		friend class HashMap;
+		template <bool> friend class Iterator;
+
+		const std::vector<Node *> *table;
+		size_t bucket;
+		Node *node;
+	};
+
+	typedef Iterator<false> iterator;
+	typedef Iterator<true> const_iterator;
+
+	/**
+	 * Iterator over the chain of a single bucket
+	 */
+	class local_iterator {
+
+	public:
+		typedef std::forward_iterator_tag iterator_category;
+		typedef typename HashMap::value_type value_type;
+		typedef std::ptrdiff_t difference_type;
+		typedef const value_type *pointer;
+		typedef const value_type& reference;
+
+		explicit local_iterator(Node *node = nullptr) : node(node) {}
+
+		reference operator*() const
+		{
+			return node->entry;
+		}
+
+		pointer operator->() const
+		{
+			return &node->entry;
+		}
+
+		local_iterator& operator++()
+		{
+			node = node->next;
+			return *this;
+		}
+
+		bool operator==(const local_iterator& other) const
+		{
+			return node == other.node;
+		}
+
+		bool operator!=(const local_iterator& other) const
+		{
+			return node != other.node;
+		}
+
+	private:
+		Node *node;
+	};
+
+	explicit HashMap(size_t bucketCount = Capacity::buckets(16),
+		const HashPolicy& hash = HashPolicy(),
+		const EqualPolicy& equal = EqualPolicy(),
+		const Allocator& allocator = Allocator());
+	~HashMap();
+
+	HashMap(const HashMap&) = delete;
+	HashMap& operator=(const HashMap&) = delete;
+
+	size_t size() const
+	{
+		return entryCount;
+	}
+
+	bool empty() const
+	{
+		return entryCount == 0;
+	}
+
+	size_t bucket_count() const
+	{
+		return buckets.size();
+	}
+
+	float load_factor() const
+	{
+		return (float)entryCount / buckets.size();
+	}
+
+	float max_load_factor() const
+	{
+		return maxLoad;
+	}
+
+	void max_load_factor(float factor)
+	{
+		maxLoad = factor;
+	}
+
+	iterator begin();
+	iterator end()
+	{
+		return iterator(&buckets, buckets.size(), nullptr);
+	}
+
+	const_iterator begin() const
+	{
+		return const_cast<HashMap *>(this)->begin();
+	}
+
+	const_iterator end() const
+	{
+		return const_iterator(&buckets, buckets.size(), nullptr);
+	}
+
+	local_iterator begin(size_t bucket) const
+	{
+		return local_iterator(buckets[bucket]);
+	}
+
+	local_iterator end(size_t) const
+	{
+		return local_iterator();
+	}
+
+	template <class Q>
+	size_t bucket(const Q& key) const
+	{
+		return Capacity::index(hasher(key), buckets.size());
+	}
+
+	size_t bucket_size(size_t bucket) const;
+
+	/**
+	 * Hints the cache that bucket is about to be searched: the first call
+	 * fetches the bucket head, a later call the first node of its chain.
+	 */
+	void prefetch(size_t bucket) const
+	{
+		__builtin_prefetch(&buckets[bucket]);
+	}
+
+	void prefetchChain(size_t bucket) const
+	{
+		if (buckets[bucket] != nullptr) {
+
+			__builtin_prefetch(buckets[bucket]);
+		}
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const K& key, Args&&... args);
+
+	template <class Q>
+	iterator find(const Q& key);
+
+	template <class Q>
+	const_iterator find(const Q& key) const
+	{
+		return const_cast<HashMap *>(this)->find(key);
+	}
+
+	template <class Q>
+	size_t count(const Q& key) const
+	{
+		return find(key) != end() ? 1 : 0;
+	}
+
+	iterator erase(const_iterator position);
+
+	iterator erase(iterator position)
+	{
+		return erase(const_iterator(position));
+	}
+
+	template <class Q>
+	size_t erase(const Q& key);
+
+	void clear();
+	void rehash(size_t bucketCount);
+	void reserve(size_t entries);
+	size_t memoryUsage() const;      // bytes of bucket array and nodes
+
+	const HashPolicy& hash_function() const
+	{
+		return hasher;
+	}
+
+	const EqualPolicy& key_eq() const
+	{
+		return equal;
+	}
+
+private:
+	struct Node {
+
+		Node *next;
+		value_type entry;            // key and value stored inline
+
+		template <class... Args>
+		Node(const K& key, Args&&... args)
+			: next(nullptr), entry(std::piecewise_construct,
+				std::forward_as_tuple(key),
+				std::forward_as_tuple(std::forward<Args>(args)...)) {}
+	};
+
+	typedef typename std::allocator_traits<Allocator>::template
+		rebind_alloc<Node> NodeAllocator;
+	typedef std::allocator_traits<NodeAllocator> NodeTraits;
+
+	std::vector<Node *> buckets;     // head of every chain
+	size_t entryCount;
+	float maxLoad;
+	HashPolicy hasher;
+	EqualPolicy equal;
+	NodeAllocator nodeAllocator;
+
+	void destroy(Node *node);
+};
+
+
+/**
+ * Constructor
+ *
+ * @param bucketCount - Initial number of buckets, at least one
+ * @param hash - Hash policy, called with keys and with lookup arguments
+ * @param equal - Equality policy, called as equal(stored key, argument)
+ * @param allocator - Allocator the chain nodes are obtained from
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+HashMap<K, V, H, E, A, C, G, R>::HashMap(size_t bucketCount, const H& hash,
+	const E& equal, const A& allocator)
+	: buckets(C::buckets(bucketCount), nullptr), entryCount(0),
+	maxLoad(1.0f), hasher(hash), equal(equal), nodeAllocator(allocator)
+{
+}
+
+
+/**
+ * Destructor
+ *
+ * Releases every node.
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+HashMap<K, V, H, E, A, C, G, R>::~HashMap()
+{
+	clear();
+}
+
+
+/**
+ * Destroys a node and returns its memory to the allocator
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+void HashMap<K, V, H, E, A, C, G, R>::destroy(Node *node)
+{
+	NodeTraits::destroy(nodeAllocator, node);
+	NodeTraits::deallocate(nodeAllocator, node, 1);
+}
+
+
+/**
+ * Iterator to the first entry of the first non-empty bucket
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+typename HashMap<K, V, H, E, A, C, G, R>::iterator HashMap<K, V, H, E, A, C, G, R>::begin()
+{
+	for (size_t b = 0; b < buckets.size(); b++) {
+
+		if (buckets[b] != nullptr) {
+
+			return iterator(&buckets, b, buckets[b]);
+		}
+	}
+
+	return end();
+}
+
+
+/**
+ * Number of entries chained in one bucket
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+size_t HashMap<K, V, H, E, A, C, G, R>::bucket_size(size_t bucket) const
+{
+	size_t length = 0;
+
+	for (Node *node = buckets[bucket]; node != nullptr; node = node->next) {
+
+		length++;
+	}
+
+	return length;
+}
+
+
+/**
+ * Inserts key with a value built from args, unless key is already present
+ *
+ * @param key - Key to insert
+ * @param args - Arguments forwarded to the constructor of the value
+ *
+ * @return iterator to the entry of key, and true if it was inserted
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+template <class... Args>
+std::pair<typename HashMap<K, V, H, E, A, C, G, R>::iterator, bool>
+HashMap<K, V, H, E, A, C, G, R>::try_emplace(const K& key, Args&&... args)
+{
+	size_t index = bucket(key);
+	Node *last = nullptr;
+
+	for (Node *node = buckets[index]; node != nullptr; node = node->next) {
+
+		if (equal(node->entry.first, key)) {
+
+			return std::make_pair(iterator(&buckets, index, node), false);
+		}
+
+		last = node;
+	}
+
+	size_t grown = G::next(buckets.size(), entryCount + 1, maxLoad);
+
+	if (grown > 0) {
+
+		rehash(grown);
+		index = bucket(key);
+		last = buckets[index];
+
+		while (last != nullptr && last->next != nullptr) {
+
+			last = last->next;
+		}
+	}
+
+	Node *node = NodeTraits::allocate(nodeAllocator, 1);
+	NodeTraits::construct(nodeAllocator, node, key, std::forward<Args>(args)...);
+
+	if (R::atHead) {
+
+		node->next = buckets[index];
+		buckets[index] = node;
+	}
+	else if (last == nullptr) {
+
+		buckets[index] = node;
+	}
+	else {
+
+		last->next = node;
+	}
+
+	entryCount++;
+
+	return std::make_pair(iterator(&buckets, index, node), true);
+}
+
+
+/**
+ * Searches for key
+ *
+ * @param key - Key, or any argument the policies accept
+ *
+ * @return iterator to the entry, or end()
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+template <class Q>
+typename HashMap<K, V, H, E, A, C, G, R>::iterator
+HashMap<K, V, H, E, A, C, G, R>::find(const Q& key)
+{
+	size_t index = bucket(key);
+
+	for (Node *node = buckets[index]; node != nullptr; node = node->next) {
+
+		if (equal(node->entry.first, key)) {
+
+			return iterator(&buckets, index, node);
+		}
+	}
+
+	return end();
+}
+
+
+/**
+ * Removes the entry at position
+ *
+ * @return iterator to the entry that followed it
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+typename HashMap<K, V, H, E, A, C, G, R>::iterator
+HashMap<K, V, H, E, A, C, G, R>::erase(const_iterator position)
+{
+	iterator next(&buckets, position.bucket, position.node);
+	++next;
+
+	Node **link = &buckets[position.bucket];
+
+	while (*link != position.node) {
+
+		link = &(*link)->next;
+	}
+
+	*link = position.node->next;
+	destroy(position.node);
+	entryCount--;
+
+	return next;
+}
+
+
+/**
+ * Removes key if it is present
+ *
+ * @return number of entries removed, 0 or 1
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+template <class Q>
+size_t HashMap<K, V, H, E, A, C, G, R>::erase(const Q& key)
+{
+	Node **link = &buckets[bucket(key)];
+
+	for (; *link != nullptr; link = &(*link)->next) {
+
+		if (equal((*link)->entry.first, key)) {
+
+			Node *node = *link;
+
+			*link = node->next;
+			destroy(node);
+			entryCount--;
+
+			return 1;
+		}
+	}
+
+	return 0;
+}
+
+
+/**
+ * Removes every entry, keeping the bucket count
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+void HashMap<K, V, H, E, A, C, G, R>::clear()
+{
+	for (auto& head : buckets) {
+
+		while (head != nullptr) {
+
+			Node *node = head;
+
+			head = node->next;
+			destroy(node);
+		}
+	}
+
+	entryCount = 0;
+}
+
+
+/**
+ * Redistributes the chains over bucketCount buckets, rounded as the
+ * capacity policy requires. Entries that end up in the same bucket keep
+ * their relative order. A static capacity never changes.
+ *
+ * @param bucketCount - New number of buckets, at least one
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+void HashMap<K, V, H, E, A, C, G, R>::rehash(size_t bucketCount)
+{
+	if (C::fixed) {
+
+		return;
+	}
+
+	std::vector<Node *> old(C::buckets(bucketCount), nullptr);
+	std::vector<Node *> tails(old.size(), nullptr);
+
+	old.swap(buckets);
+
+	for (Node *head : old) {
+
+		while (head != nullptr) {
+
+			Node *node = head;
+			size_t index = bucket(node->entry.first);
+
+			head = node->next;
+			node->next = nullptr;
+
+			if (tails[index] == nullptr) {
+
+				buckets[index] = node;
+			}
+			else {
+
+				tails[index]->next = node;
+			}
+
+			tails[index] = node;
+		}
+	}
+}
+
+
+/**
+ * Grows the bucket array so entries can be inserted without rehashing
+ *
+ * @param entries - Number of entries the map should be able to hold
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+void HashMap<K, V, H, E, A, C, G, R>::reserve(size_t entries)
+{
+	size_t wanted = (size_t)(entries / maxLoad) + 1;
+
+	if (!C::fixed && wanted > buckets.size()) {
+
+		rehash(wanted);
+	}
+}
+
+
+/**
+ * Bytes of the bucket array plus the chain nodes
+ */
+template <class K, class V, class H, class E, class A, class C, class G,
+	class R>
+size_t HashMap<K, V, H, E, A, C, G, R>::memoryUsage() const
+{
+	return buckets.capacity() * sizeof(Node *) + entryCount * sizeof(Node);
+}
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * @file hash_mix.h - Seeded 64-bit hashing of byte strings.
+ *
+ * @brief - Used by the table variants that need well mixed, independent
+ * hash values (perfect hashing, cuckoo hashing, filters). Eight bytes are
+ * consumed per step and every step goes through a 64-bit finalizer, so
+ * changing the seed gives an unrelated hash function.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HASH_MIX_H
+#define __HASH_MIX_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+
+using std::string_view;
+
+/**
+ * 64-bit finalizer from MurmurHash3, every input bit affects every output bit
+ */
+inline uint64_t mix64(uint64_t x)
+{
+	x ^= x >> 33;
+	x *= 0xff51afd7ed558ccdULL;
+	x ^= x >> 33;
+	x *= 0xc4ceb9fe1a85ec53ULL;
+	x ^= x >> 33;
+
+	return x;
+}
+
+
+/**
+ * Hashes the characters of key with the given seed
+ *
+ * @param key - Bytes to hash
+ * @param seed - Selects the hash function
+ */
+inline uint64_t hashBytes(string_view key, uint64_t seed)
+{
+	const uint64_t MULTIPLIER = 0x9e3779b97f4a7c15ULL;
+	const char *data = key.data();
+	size_t size = key.size();
+	uint64_t hash = seed ^ (size * MULTIPLIER);
+	size_t i = 0;
+
+	for (; i + 8 <= size; i += 8) {
+
+		uint64_t chunk;
+		memcpy(&chunk, data + i, 8);
+		hash = (hash ^ mix64(chunk)) * MULTIPLIER;
+	}
+
+	if (i < size) {
+
+		uint64_t chunk = 0;
+		memcpy(&chunk, data + i, size - i);
+		hash = (hash ^ mix64(chunk)) * MULTIPLIER;
+	}
+
+	return mix64(hash);
+}
+
+#endif
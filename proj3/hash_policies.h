@@ -0,0 +1,135 @@
+/**
+ * @file hash_policies.h - Compile-time policies that configure a HashMap:
+ * how a hash becomes a bucket, when the bucket array grows and where a
+ * new key goes in its chain.
+ *
+ * @brief - Every policy is a class of static constexpr members, so the
+ * choice costs nothing at run time. With StaticCapacity the bucket count
+ * is a constant and the modulo becomes a mask (power of two sizes) or a
+ * multiply by the compiler; the dynamic policies read the count from the
+ * bucket array. Differently configured tables are different types and
+ * live side by side in one program.
+ *
+ *    capacity     StaticCapacity<N>, DynamicCapacity, PowerOfTwoCapacity
+ *    growth       NoGrowth, DoublingGrowth
+ *    collision    ChainAppend, ChainPrepend
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HASH_POLICIES_H
+#define __HASH_POLICIES_H
+
+#include <cstddef>
+
+/**
+ * Exactly N buckets, fixed when the program is compiled
+ */
+template <size_t N>
+struct StaticCapacity {
+
+	static_assert(N > 0, "a table needs at least one bucket");
+
+	static constexpr bool fixed = true;
+
+	static constexpr size_t buckets(size_t)
+	{
+		return N;
+	}
+
+	static constexpr size_t index(size_t hash, size_t)
+	{
+		return (N & (N - 1)) == 0 ? hash & (N - 1) : hash % N;
+	}
+};
+
+
+/**
+ * Any bucket count chosen at run time, reduced with %
+ */
+struct DynamicCapacity {
+
+	static constexpr bool fixed = false;
+
+	static constexpr size_t buckets(size_t wanted)
+	{
+		return wanted > 0 ? wanted : 1;
+	}
+
+	static constexpr size_t index(size_t hash, size_t buckets)
+	{
+		return hash % buckets;
+	}
+};
+
+
+/**
+ * Bucket counts rounded up to a power of two, reduced with a mask
+ */
+struct PowerOfTwoCapacity {
+
+	static constexpr bool fixed = false;
+
+	static constexpr size_t buckets(size_t wanted)
+	{
+		size_t count = 1;
+
+		while (count < wanted) {
+
+			count *= 2;
+		}
+
+		return count;
+	}
+
+	static constexpr size_t index(size_t hash, size_t buckets)
+	{
+		return hash & (buckets - 1);
+	}
+};
+
+
+/**
+ * The bucket array keeps its size, chains grow instead
+ */
+struct NoGrowth {
+
+	static constexpr size_t next(size_t, size_t, float)
+	{
+		return 0;
+	}
+};
+
+
+/**
+ * The bucket array doubles once entries passes maxLoad per bucket
+ */
+struct DoublingGrowth {
+
+	static constexpr size_t next(size_t buckets, size_t entries, float maxLoad)
+	{
+		return entries > maxLoad * buckets ? buckets * 2 : 0;
+	}
+};
+
+
+/**
+ * New keys go to the end of their chain, chains stay in insertion order
+ */
+struct ChainAppend {
+
+	static constexpr bool atHead = false;
+};
+
+
+/**
+ * New keys go to the front of their chain, so the most recently inserted
+ * keys are the first ones a lookup compares
+ */
+struct ChainPrepend {
+
+	static constexpr bool atHead = true;
+};
+
+#endif
@@ -0,0 +1,106 @@
+/**
+ * @file mapped_file.cpp - Maps files into memory with mmap.
+ *
+ * @brief - The mapping is private and read-only. It is released when the
+ * MappedFile is closed or destroyed.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "mapped_file.h"
+
+/**
+ * Constructor
+ *
+ * Nothing is mapped until open is called.
+ */
+MappedFile::MappedFile()
+{
+	bytes = nullptr;
+	length = 0;
+	mapped = false;
+}
+
+
+/**
+ * Destructor
+ *
+ * Unmaps the file if one is open.
+ */
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+
+/**
+ * Maps the given file read-only. An empty file opens successfully with a
+ * size of zero and no mapping behind it.
+ *
+ * @param filename - Name of the file to map
+ *
+ * @return false if the file could not be opened or mapped
+ */
+bool MappedFile::open(string filename)
+{
+	close();
+
+	int fd = ::open(filename.c_str(), O_RDONLY);
+
+	if (fd < 0) {
+
+		return false;
+	}
+
+	struct stat info;
+
+	if (fstat(fd, &info) != 0 || !S_ISREG(info.st_mode)) {
+
+		::close(fd);
+		return false;
+	}
+
+	length = (size_t)info.st_size;
+
+	if (length > 0) {
+
+		void *address = mmap(nullptr, length, PROT_READ, MAP_PRIVATE, fd, 0);
+
+		if (address == MAP_FAILED) {
+
+			::close(fd);
+			length = 0;
+			return false;
+		}
+
+		madvise(address, length, MADV_SEQUENTIAL);
+
+		bytes = (const char *)address;
+		mapped = true;
+	}
+
+	::close(fd);
+
+	return true;
+}
+
+
+/**
+ * Releases the mapping of the current file
+ */
+void MappedFile::close()
+{
+	if (mapped) {
+
+		munmap((void *)bytes, length);
+	}
+
+	bytes = nullptr;
+	length = 0;
+	mapped = false;
+}
@@ -0,0 +1,46 @@
+/**
+ * @file mapped_file.h - Declaration of a read-only memory mapped file.
+ *
+ * @brief - Maps a whole file into memory so it can be parsed or queried
+ * in place, without copying it through a stream buffer.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __MAPPED_FILE_H
+#define __MAPPED_FILE_H
+
+#include <string>
+#include <cstddef>
+
+using std::string;
+
+class MappedFile {
+
+public:
+	MappedFile();
+	~MappedFile();
+	bool open(string filename);      // map filename read-only
+	void close();                    // unmap the current file
+
+	const char *data() const         // first byte of the file
+	{
+		return bytes;
+	}
+
+	size_t size() const              // length of the file in bytes
+	{
+		return length;
+	}
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile& operator=(const MappedFile&);
+
+	const char *bytes;
+	size_t length;
+	bool mapped;                     // false for empty files
+};
+
+#endif
@@ -0,0 +1,302 @@
+/**
+ * @file membership_filter.cpp - Counting blocked Bloom filter.
+ *
+ * @brief - The usual Bloom filter formulas, -ln(p) / ln(2)^2 counters
+ * per key and ln(2) probes per counter per key, assume every probe can
+ * land anywhere. Here all probes of a key share one block, and blocks
+ * that happen to hold more keys than average pass more absent keys, so
+ * those formulas only give the starting size. Blocks are then added
+ * until the rate predicted from the spread of block loads is a tenth
+ * under the target. Counters are packed sixteen to a 64-bit word.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <cmath>
+#include "membership_filter.h"
+#include "hash_mix.h"
+
+static const uint64_t FILTER_SEED = 0x5bd1e9955bd1e995ULL;
+
+
+/**
+ * Expected false positive rate of a blocked filter. The number of keys in
+ * the block an absent key maps to is Poisson distributed around the
+ * average, and with load keys in it each counter of the block is still
+ * zero with probability (1 - 1 / counters)^(probes * load).
+ *
+ * @param keysPerBlock - Average keys per block
+ * @param probes - Counters set per key, all in one block
+ * @param counters - Counters per block
+ */
+static double blockedRate(double keysPerBlock, int probes, int counters)
+{
+	double rate = 0.0;
+	double weight = std::exp(-keysPerBlock);      // P(load = 0)
+	double spread = 10.0 * std::sqrt(keysPerBlock) + 20.0;
+
+	for (int load = 0; load <= keysPerBlock + spread; load++) {
+
+		double unset = std::pow(1.0 - 1.0 / counters, (double)probes * load);
+
+		rate += weight * std::pow(1.0 - unset, probes);
+		weight *= keysPerBlock / (load + 1);
+	}
+
+	return rate;
+}
+
+
+/**
+ * Constructor
+ *
+ * @param expectedKeys - Number of keys the filter will hold
+ * @param falsePositiveRate - Wanted fraction of absent keys that pass
+ */
+MembershipFilter::MembershipFilter(size_t expectedKeys,
+	double falsePositiveRate)
+{
+	if (falsePositiveRate <= 0.0 || falsePositiveRate >= 1.0) {
+
+		falsePositiveRate = 0.01;
+	}
+
+	double keys = expectedKeys > 0 ? expectedKeys : 1;
+	double perKey = -std::log(falsePositiveRate) / (std::log(2.0) * std::log(2.0));
+	size_t count = (size_t)std::ceil(perKey * keys / COUNTERS);
+
+	// aim a tenth under the target, one filter's keys spread unevenly
+	// enough to land on either side of the expected rate
+	double aim = 0.9 * falsePositiveRate;
+
+	// grow by about 1.5% until the best probe count meets the aim
+	for (;;) {
+
+		double best = 1.0;
+
+		for (int probes = 1; probes <= 16; probes++) {
+
+			double rate = blockedRate(keys / count, probes, COUNTERS);
+
+			if (rate < best) {
+
+				best = rate;
+				probeCount = probes;
+			}
+		}
+
+		if (best <= aim) {
+
+			break;
+		}
+
+		count += count / 64 + 1;
+	}
+
+	blocks.assign(count, Block());
+	target = falsePositiveRate;
+	queryCount = 0;
+	rejectCount = 0;
+	falsePositiveCount = 0;
+}
+
+
+/**
+ * Counter of the next probe. Every probe takes seven fresh bits of a
+ * remix of the hash, so the probes of a key are independent of each
+ * other and of the bits that chose the block.
+ *
+ * @param bits - The key's hash before the first probe, then the bits
+ * left over by the previous one
+ * @param probe - Number of the probe, counted from 0
+ */
+unsigned int MembershipFilter::nextCounter(uint64_t& bits, int probe) const
+{
+	if (probe % 9 == 0) {
+
+		bits = mix64(bits + probe);
+	}
+
+	unsigned int counter = (unsigned int)(bits % COUNTERS);
+
+	bits /= COUNTERS;
+
+	return counter;
+}
+
+
+/**
+ * Increments the counters of word
+ *
+ * @param word - Key being added to the table
+ */
+void MembershipFilter::add(string_view word)
+{
+	uint64_t hash = hashBytes(word, FILTER_SEED);
+	Block& block = blocks[blockOf(hash)];
+	uint64_t bits = hash;
+
+	for (int p = 0; p < probeCount; p++) {
+
+		unsigned int counter = nextCounter(bits, p);
+		uint64_t& counters = block.words[counter / 16];
+		int shift = (counter % 16) * 4;
+
+		if (((counters >> shift) & 0xF) != 0xF) {
+
+			counters += (uint64_t)1 << shift;
+		}
+	}
+}
+
+
+/**
+ * Decrements the counters of word. Only call it for a word that was added
+ * and is still present, otherwise other keys could become false negatives.
+ *
+ * @param word - Key being removed from the table
+ */
+void MembershipFilter::remove(string_view word)
+{
+	uint64_t hash = hashBytes(word, FILTER_SEED);
+	Block& block = blocks[blockOf(hash)];
+	uint64_t bits = hash;
+
+	for (int p = 0; p < probeCount; p++) {
+
+		unsigned int counter = nextCounter(bits, p);
+		uint64_t& counters = block.words[counter / 16];
+		int shift = (counter % 16) * 4;
+		uint64_t value = (counters >> shift) & 0xF;
+
+		if (value != 0xF && value != 0) {
+
+			counters -= (uint64_t)1 << shift;
+		}
+	}
+}
+
+
+/**
+ * Checks the counters of word and counts the query and its outcome
+ *
+ * @param word - Key we are searching for
+ *
+ * @return false if word was certainly never added
+ */
+bool MembershipFilter::mayContain(string_view word)
+{
+	queryCount++;
+
+	if (!test(word)) {
+
+		rejectCount++;
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * Checks the counters of word without touching the statistics, for
+ * diagnostics that must not skew the observed false positive rate
+ *
+ * @param word - Key we are searching for
+ *
+ * @return false if word was certainly never added
+ */
+bool MembershipFilter::test(string_view word) const
+{
+	uint64_t hash = hashBytes(word, FILTER_SEED);
+	const Block& block = blocks[blockOf(hash)];
+	uint64_t bits = hash;
+
+	for (int p = 0; p < probeCount; p++) {
+
+		unsigned int counter = nextCounter(bits, p);
+
+		if (((block.words[counter / 16] >> ((counter % 16) * 4)) & 0xF) == 0) {
+
+			return false;
+		}
+	}
+
+	return true;
+}
+
+
+/**
+ * Tells the filter that the last key it passed turned out to be absent
+ */
+void MembershipFilter::recordFalsePositive()
+{
+	falsePositiveCount++;
+}
+
+
+/**
+ * Number of mayContain calls
+ */
+unsigned long MembershipFilter::queries() const
+{
+	return queryCount;
+}
+
+
+/**
+ * Number of queries answered without touching the table
+ */
+unsigned long MembershipFilter::rejected() const
+{
+	return rejectCount;
+}
+
+
+/**
+ * Number of absent keys the filter let through
+ */
+unsigned long MembershipFilter::falsePositives() const
+{
+	return falsePositiveCount;
+}
+
+
+/**
+ * Observed false positive rate: absent keys let through over all absent
+ * keys queried
+ */
+double MembershipFilter::falsePositiveRate() const
+{
+	unsigned long absent = rejectCount + falsePositiveCount;
+
+	return absent == 0 ? 0.0 : (double)falsePositiveCount / absent;
+}
+
+
+/**
+ * False positive rate the filter was sized for
+ */
+double MembershipFilter::targetRate() const
+{
+	return target;
+}
+
+
+/**
+ * Number of counters checked per key
+ */
+int MembershipFilter::probes() const
+{
+	return probeCount;
+}
+
+
+/**
+ * Bytes used by the counter blocks
+ */
+size_t MembershipFilter::memoryUsage() const
+{
+	return blocks.size() * sizeof(Block);
+}
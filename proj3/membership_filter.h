@@ -0,0 +1,67 @@
+/**
+ * @file membership_filter.h - Declaration of the counting blocked Bloom
+ * filter that can sit in front of a Hash table.
+ *
+ * @brief - All probes of a key fall into one 64-byte block of 128 four-bit
+ * counters, so rejecting an absent key costs a single cache miss instead
+ * of a chain walk. Counters make removal possible: remove decrements what
+ * add incremented. A counter that reaches 15 sticks there, so overflow can
+ * only cost extra false positives, never a false negative.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __MEMBERSHIP_FILTER_H
+#define __MEMBERSHIP_FILTER_H
+
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+using std::string_view;
+using std::vector;
+
+class MembershipFilter {
+
+public:
+	MembershipFilter(size_t expectedKeys, double falsePositiveRate);
+	void add(string_view word);              // count word in
+	void remove(string_view word);           // count a present word out
+	bool mayContain(string_view word);       // false means surely absent
+	bool test(string_view word) const;       // mayContain, not counted
+	void recordFalsePositive();              // a passed key was not stored
+
+	unsigned long queries() const;           // mayContain calls
+	unsigned long rejected() const;          // answered "surely absent"
+	unsigned long falsePositives() const;    // passed but absent
+	double falsePositiveRate() const;        // observed, over absent keys
+	double targetRate() const;               // rate the filter was sized for
+	int probes() const;                      // counters touched per key
+	size_t memoryUsage() const;
+
+private:
+	static const int COUNTERS = 128;         // four-bit counters per block
+
+	struct alignas(64) Block {
+
+		uint64_t words[8];
+	};
+
+	vector<Block> blocks;
+	int probeCount;
+	double target;
+	unsigned long queryCount;
+	unsigned long rejectCount;
+	unsigned long falsePositiveCount;
+
+	size_t blockOf(uint64_t hash) const
+	{
+		return (size_t)(((hash >> 32) * blocks.size()) >> 32);
+	}
+
+	unsigned int nextCounter(uint64_t& bits, int probe) const;
+};
+
+#endif
@@ -0,0 +1,271 @@
+/**
+ * @file node_pool.h - Slab allocator for fixed-size chain nodes and the
+ * allocator adaptor that lets a HashMap draw its nodes from it.
+ *
+ * @brief - A NodePool carves nodes out of large slabs with a bump pointer
+ * and recycles freed nodes through an intrusive free list, so inserting a
+ * key costs no general-purpose malloc and no per-node allocator header.
+ * Slabs are only returned when the pool is destroyed, all at once. A
+ * PoolFamily holds one NodePool per node size, shared by an allocator
+ * and every copy and rebind of it.
+ *
+ *    HashMap<K, V, HashPolicy, EqualPolicy, PoolAllocator<pair<const K, V>>>
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __NODE_POOL_H
+#define __NODE_POOL_H
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <vector>
+
+class NodePool {
+
+public:
+	NodePool(size_t nodeSize, size_t nodeAlign, size_t nodesPerSlab = 4096);
+	~NodePool();
+
+	NodePool(const NodePool&) = delete;
+	NodePool& operator=(const NodePool&) = delete;
+
+	void *allocate();                // one node, never fails but throws
+	void deallocate(void *node);     // back onto the free list
+	size_t reserved() const;         // bytes held in slabs
+	size_t inUse() const;            // nodes handed out and not freed
+
+private:
+	struct FreeNode {
+
+		FreeNode *next;
+	};
+
+	std::vector<char *> slabs;
+	FreeNode *freeList;
+	char *bump;                      // next untouched node of the last slab
+	char *slabEnd;
+	size_t slot;                     // node size rounded up to its alignment
+	size_t align;
+	size_t perSlab;
+	size_t live;
+};
+
+
+/**
+ * The pools of one allocator family, one per node size and alignment.
+ * A pool is created the first time its size is asked for and lives as
+ * long as the family.
+ */
+class PoolFamily {
+
+public:
+	NodePool& pool(size_t nodeSize, size_t nodeAlign);
+
+private:
+	struct SizeClass {
+
+		size_t size;
+		size_t align;
+		std::unique_ptr<NodePool> pool;
+	};
+
+	std::vector<SizeClass> classes;
+};
+
+
+/**
+ * Standard allocator drawing single objects from a NodePool. Copies and
+ * rebinds share one PoolFamily, so they compare equal and a container's
+ * node allocator draws from the family it was constructed with; each
+ * type gets the family's pool for its size. Requests for more than one
+ * object go to the global allocator.
+ */
+template <class T>
+class PoolAllocator {
+
+public:
+	typedef T value_type;
+
+	PoolAllocator()
+		: family(std::make_shared<PoolFamily>()),
+		pool(&family->pool(sizeof(T), alignof(T))) {}
+
+	template <class U>
+	PoolAllocator(const PoolAllocator<U>& other)
+		: family(other.family),
+		pool(&family->pool(sizeof(T), alignof(T))) {}
+
+	T *allocate(size_t n)
+	{
+		if (n == 1) {
+
+			return static_cast<T *>(pool->allocate());
+		}
+
+		return std::allocator<T>().allocate(n);
+	}
+
+	void deallocate(T *pointer, size_t n)
+	{
+		if (n == 1) {
+
+			pool->deallocate(pointer);
+		}
+		else {
+
+			std::allocator<T>().deallocate(pointer, n);
+		}
+	}
+
+	const NodePool& nodePool() const
+	{
+		return *pool;
+	}
+
+	template <class U>
+	bool operator==(const PoolAllocator<U>& other) const
+	{
+		return family == other.family;
+	}
+
+	template <class U>
+	bool operator!=(const PoolAllocator<U>& other) const
+	{
+		return family != other.family;
+	}
+
+private:
+	template <class U>
+	friend class PoolAllocator;
+
+	std::shared_ptr<PoolFamily> family;
+	NodePool *pool;                  // the family's pool for sizeof(T)
+};
+
+
+/**
+ * Constructor
+ *
+ * @param nodeSize - Size of every node
+ * @param nodeAlign - Alignment of every node
+ * @param nodesPerSlab - Nodes obtained per slab allocation
+ */
+inline NodePool::NodePool(size_t nodeSize, size_t nodeAlign,
+	size_t nodesPerSlab)
+{
+	align = nodeAlign < alignof(FreeNode) ? alignof(FreeNode) : nodeAlign;
+	slot = nodeSize < sizeof(FreeNode) ? sizeof(FreeNode) : nodeSize;
+	slot = (slot + align - 1) / align * align;
+	perSlab = nodesPerSlab > 0 ? nodesPerSlab : 1;
+	freeList = nullptr;
+	bump = nullptr;
+	slabEnd = nullptr;
+	live = 0;
+}
+
+
+/**
+ * Destructor
+ *
+ * Frees every slab. Nodes still in use are released with them, without
+ * running any destructor.
+ */
+inline NodePool::~NodePool()
+{
+	for (char *slab : slabs) {
+
+		::operator delete(slab, std::align_val_t(align));
+	}
+}
+
+
+/**
+ * Hands out one node: a recycled one if any, else the next node of the
+ * current slab, else the first node of a new slab
+ */
+inline void *NodePool::allocate()
+{
+	live++;
+
+	if (freeList != nullptr) {
+
+		FreeNode *node = freeList;
+
+		freeList = node->next;
+		return node;
+	}
+
+	if (bump == slabEnd) {
+
+		char *slab = static_cast<char *>(::operator new(slot * perSlab,
+			std::align_val_t(align)));
+
+		slabs.push_back(slab);
+		bump = slab;
+		slabEnd = slab + slot * perSlab;
+	}
+
+	void *node = bump;
+
+	bump += slot;
+	return node;
+}
+
+
+/**
+ * Returns a node to the free list
+ */
+inline void NodePool::deallocate(void *node)
+{
+	FreeNode *freed = static_cast<FreeNode *>(node);
+
+	freed->next = freeList;
+	freeList = freed;
+	live--;
+}
+
+
+/**
+ * Bytes obtained from the global allocator
+ */
+inline size_t NodePool::reserved() const
+{
+	return slabs.size() * slot * perSlab;
+}
+
+
+/**
+ * Nodes currently allocated
+ */
+inline size_t NodePool::inUse() const
+{
+	return live;
+}
+
+
+/**
+ * The family's pool for nodes of one size and alignment
+ *
+ * @param nodeSize - Size of every node
+ * @param nodeAlign - Alignment of every node
+ */
+inline NodePool& PoolFamily::pool(size_t nodeSize, size_t nodeAlign)
+{
+	for (SizeClass& sized : classes) {
+
+		if (sized.size == nodeSize && sized.align == nodeAlign) {
+
+			return *sized.pool;
+		}
+	}
+
+	classes.push_back(SizeClass{ nodeSize, nodeAlign,
+		std::unique_ptr<NodePool>(new NodePool(nodeSize, nodeAlign)) });
+
+	return *classes.back().pool;
+}
+
+#endif
@@ -0,0 +1,745 @@
+/**
+ * @file radix_tree.cpp - Insertion, lookup and prefix queries for the
+ * adaptive radix tree.
+ *
+ * @brief - A node is grown to the next larger type when a child does not
+ * fit, and split when a new word leaves its compressed prefix part way.
+ * Prefix characters are interned once in the arena; splitting a node only
+ * moves its (offset, length) window, nothing is copied.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <cstring>
+#include "radix_tree.h"
+#include "mapped_file.h"
+#include "word_loader.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+
+/**
+ * Constructor
+ *
+ * Starts with an empty tree.
+ */
+RadixTree::RadixTree()
+{
+	root = nullptr;
+	words = 0;
+
+	for (int type = 0; type < 4; type++) {
+
+		nodes[type] = 0;
+	}
+}
+
+
+/**
+ * Destructor
+ *
+ * Releases every node.
+ */
+RadixTree::~RadixTree()
+{
+	release(root);
+}
+
+
+/**
+ * Adds a word to the tree
+ *
+ * @param word - Word to insert
+ *
+ * @return false if the word was already present
+ */
+bool RadixTree::insert(string_view word)
+{
+	Node **ref = &root;
+	size_t depth = 0;
+
+	while (true) {
+
+		Node *node = *ref;
+
+		if (node == nullptr) {
+
+			*ref = makeLeaf(word.substr(depth));
+			words++;
+
+			return true;
+		}
+
+		size_t matched = matchPrefix(node, word, depth);
+
+		if (matched < node->prefixLength) {
+
+			// the word leaves the compressed path: split it at matched
+			Node4 *parent = makeNode4(node->prefixOffset, (uint32_t)matched);
+			uint8_t byte = (uint8_t)arena.view(node->prefixOffset,
+				node->prefixLength)[matched];
+
+			node->prefixOffset += (uint32_t)matched + 1;
+			node->prefixLength -= (uint32_t)matched + 1;
+			*ref = parent;
+			addChild(ref, byte, node);
+
+			if (depth + matched == word.size()) {
+
+				parent->terminal = 1;
+			}
+			else {
+
+				addChild(ref, (uint8_t)word[depth + matched],
+					makeLeaf(word.substr(depth + matched + 1)));
+			}
+
+			words++;
+
+			return true;
+		}
+
+		depth += node->prefixLength;
+
+		if (depth == word.size()) {
+
+			bool added = !node->terminal;
+
+			node->terminal = 1;
+			words += added;
+
+			return added;
+		}
+
+		Node **child = findChild(node, (uint8_t)word[depth]);
+
+		if (child == nullptr) {
+
+			addChild(ref, (uint8_t)word[depth], makeLeaf(word.substr(depth + 1)));
+			words++;
+
+			return true;
+		}
+
+		ref = child;
+		depth++;
+	}
+}
+
+
+/**
+ * Exact lookup of a word
+ *
+ * @param word - Word we are searching for
+ */
+bool RadixTree::search(string_view word) const
+{
+	const Node *node = root;
+	size_t depth = 0;
+
+	while (node != nullptr) {
+
+		if (matchPrefix(node, word, depth) < node->prefixLength) {
+
+			return false;
+		}
+
+		depth += node->prefixLength;
+
+		if (depth == word.size()) {
+
+			return node->terminal;
+		}
+
+		Node **child = findChild(const_cast<Node *>(node), (uint8_t)word[depth]);
+
+		node = child == nullptr ? nullptr : *child;
+		depth++;
+	}
+
+	return false;
+}
+
+
+/**
+ * Inserts every word of a file, read through a read-only mapping
+ *
+ * @param filename - File of whitespace separated words
+ *
+ * @return false if the file could not be opened
+ */
+bool RadixTree::loadFile(string filename)
+{
+	MappedFile file;
+
+	if (!file.open(filename)) {
+
+		return false;
+	}
+
+	forEachWord(file.data(), file.size(), [this](string_view word) {
+
+		insert(word);
+	});
+
+	return true;
+}
+
+
+/**
+ * Calls visit for every stored word that starts with prefix, in sorted
+ * byte order. The view passed to visit is only valid during the call.
+ *
+ * @param prefix - Leading characters, empty for every word
+ * @param visit - Called once per word
+ */
+void RadixTree::forEachPrefixed(string_view prefix,
+	const std::function<void(string_view)>& visit) const
+{
+	const Node *node = root;
+	size_t depth = 0;
+	string word(prefix);
+
+	while (node != nullptr) {
+
+		size_t matched = matchPrefix(node, prefix, depth);
+
+		if (depth + matched == prefix.size()) {
+
+			// the prefix ends inside this node's path: all of it matches
+			string_view path = arena.view(node->prefixOffset,
+				node->prefixLength);
+
+			word.append(path.substr(matched));
+			enumerate(node, word, visit);
+
+			return;
+		}
+
+		if (matched < node->prefixLength) {
+
+			return;
+		}
+
+		depth += node->prefixLength;
+
+		Node **child = findChild(const_cast<Node *>(node), (uint8_t)prefix[depth]);
+
+		node = child == nullptr ? nullptr : *child;
+		depth++;
+	}
+}
+
+
+/**
+ * Every stored word that starts with prefix, sorted
+ *
+ * @param prefix - Leading characters, empty for every word
+ */
+vector<string> RadixTree::startingWith(string_view prefix) const
+{
+	vector<string> result;
+
+	forEachPrefixed(prefix, [&result](string_view word) {
+
+		result.emplace_back(word);
+	});
+
+	return result;
+}
+
+
+/**
+ * Finds the longest stored word that text starts with
+ *
+ * @param text - Text to match against
+ * @param match - Set to the matching leading part of text
+ *
+ * @return false if no stored word is a prefix of text
+ */
+bool RadixTree::longestPrefix(string_view text, string_view& match) const
+{
+	const Node *node = root;
+	size_t depth = 0;
+	bool found = false;
+
+	while (node != nullptr) {
+
+		if (matchPrefix(node, text, depth) < node->prefixLength) {
+
+			break;
+		}
+
+		depth += node->prefixLength;
+
+		if (node->terminal) {
+
+			match = text.substr(0, depth);
+			found = true;
+		}
+
+		if (depth == text.size()) {
+
+			break;
+		}
+
+		Node **child = findChild(const_cast<Node *>(node), (uint8_t)text[depth]);
+
+		node = child == nullptr ? nullptr : *child;
+		depth++;
+	}
+
+	return found;
+}
+
+
+/**
+ * Number of distinct words stored
+ */
+size_t RadixTree::size() const
+{
+	return words;
+}
+
+
+/**
+ * Number of nodes of one type
+ *
+ * @param type - 4, 16, 48 or 256
+ */
+size_t RadixTree::nodeCount(int type) const
+{
+	switch (type) {
+
+	case 4:
+		return nodes[NODE4];
+	case 16:
+		return nodes[NODE16];
+	case 48:
+		return nodes[NODE48];
+	case 256:
+		return nodes[NODE256];
+	}
+
+	return 0;
+}
+
+
+/**
+ * Bytes held by the nodes and the prefix arena
+ */
+size_t RadixTree::memoryUsage() const
+{
+	return nodes[NODE4] * sizeof(Node4) + nodes[NODE16] * sizeof(Node16)
+		+ nodes[NODE48] * sizeof(Node48) + nodes[NODE256] * sizeof(Node256)
+		+ arena.capacity();
+}
+
+
+/**
+ * A childless node holding the rest of a word as its prefix
+ *
+ * @param suffix - Characters after the byte that leads to the leaf
+ */
+RadixTree::Node *RadixTree::makeLeaf(string_view suffix)
+{
+	Node4 *leaf = makeNode4(arena.intern(suffix), (uint32_t)suffix.size());
+
+	leaf->terminal = 1;
+
+	return leaf;
+}
+
+
+/**
+ * An empty Node4 whose prefix is a window of the arena
+ */
+RadixTree::Node4 *RadixTree::makeNode4(uint32_t prefixOffset,
+	uint32_t prefixLength)
+{
+	Node4 *node = new Node4();
+
+	node->type = NODE4;
+	node->prefixOffset = prefixOffset;
+	node->prefixLength = prefixLength;
+	nodes[NODE4]++;
+
+	return node;
+}
+
+
+/**
+ * Releases a node and everything below it
+ */
+void RadixTree::release(Node *node)
+{
+	if (node == nullptr) {
+
+		return;
+	}
+
+	switch (node->type) {
+
+	case NODE4: {
+
+		Node4 *small = static_cast<Node4 *>(node);
+
+		for (int i = 0; i < small->count; i++) {
+
+			release(small->children[i]);
+		}
+
+		delete small;
+		break;
+	}
+
+	case NODE16: {
+
+		Node16 *medium = static_cast<Node16 *>(node);
+
+		for (int i = 0; i < medium->count; i++) {
+
+			release(medium->children[i]);
+		}
+
+		delete medium;
+		break;
+	}
+
+	case NODE48: {
+
+		Node48 *large = static_cast<Node48 *>(node);
+
+		for (int i = 0; i < large->count; i++) {
+
+			release(large->children[i]);
+		}
+
+		delete large;
+		break;
+	}
+
+	default: {
+
+		Node256 *full = static_cast<Node256 *>(node);
+
+		for (int i = 0; i < 256; i++) {
+
+			release(full->children[i]);
+		}
+
+		delete full;
+	}
+	}
+}
+
+
+/**
+ * Slot holding the child reached by byte, or null
+ *
+ * @param node - Inner node
+ * @param byte - Next byte of the key
+ */
+RadixTree::Node **RadixTree::findChild(Node *node, uint8_t byte)
+{
+	switch (node->type) {
+
+	case NODE4: {
+
+		Node4 *small = static_cast<Node4 *>(node);
+
+		for (int i = 0; i < small->count; i++) {
+
+			if (small->keys[i] == byte) {
+
+				return &small->children[i];
+			}
+		}
+
+		return nullptr;
+	}
+
+	case NODE16: {
+
+		Node16 *medium = static_cast<Node16 *>(node);
+
+#ifdef __SSE2__
+		__m128i keys = _mm_load_si128((const __m128i *)medium->keys);
+		__m128i equal = _mm_cmpeq_epi8(keys, _mm_set1_epi8((char)byte));
+		unsigned int mask = (unsigned int)_mm_movemask_epi8(equal)
+			& ((1u << medium->count) - 1);
+
+		return mask == 0 ? nullptr
+			: &medium->children[__builtin_ctz(mask)];
+#else
+		for (int i = 0; i < medium->count; i++) {
+
+			if (medium->keys[i] == byte) {
+
+				return &medium->children[i];
+			}
+		}
+
+		return nullptr;
+#endif
+	}
+
+	case NODE48: {
+
+		Node48 *large = static_cast<Node48 *>(node);
+
+		return large->index[byte] == 0 ? nullptr
+			: &large->children[large->index[byte] - 1];
+	}
+
+	default: {
+
+		Node256 *full = static_cast<Node256 *>(node);
+
+		return full->children[byte] == nullptr ? nullptr
+			: &full->children[byte];
+	}
+	}
+}
+
+
+/**
+ * Adds a child under a byte the node does not have yet, growing the node
+ * first when it is full. Sorted node types keep their keys in order.
+ *
+ * @param ref - Slot pointing at the node, updated if it grows
+ * @param byte - Byte leading to the child
+ * @param child - New child
+ */
+void RadixTree::addChild(Node **ref, uint8_t byte, Node *child)
+{
+	Node *node = *ref;
+
+	if ((node->type == NODE4 && node->count == 4)
+		|| (node->type == NODE16 && node->count == 16)
+		|| (node->type == NODE48 && node->count == 48)) {
+
+		grow(ref);
+		node = *ref;
+	}
+
+	switch (node->type) {
+
+	case NODE4:
+	case NODE16: {
+
+		uint8_t *keys = node->type == NODE4 ? static_cast<Node4 *>(node)->keys
+			: static_cast<Node16 *>(node)->keys;
+		Node **children = node->type == NODE4
+			? static_cast<Node4 *>(node)->children
+			: static_cast<Node16 *>(node)->children;
+		int at = node->count;
+
+		while (at > 0 && keys[at - 1] > byte) {
+
+			keys[at] = keys[at - 1];
+			children[at] = children[at - 1];
+			at--;
+		}
+
+		keys[at] = byte;
+		children[at] = child;
+		break;
+	}
+
+	case NODE48: {
+
+		Node48 *large = static_cast<Node48 *>(node);
+
+		large->children[large->count] = child;
+		large->index[byte] = (uint8_t)(large->count + 1);
+		break;
+	}
+
+	default:
+		static_cast<Node256 *>(node)->children[byte] = child;
+	}
+
+	node->count++;
+}
+
+
+/**
+ * Replaces a full node with one of the next larger type holding the same
+ * header and children
+ *
+ * @param ref - Slot pointing at the node
+ */
+void RadixTree::grow(Node **ref)
+{
+	Node *node = *ref;
+	Node *bigger;
+
+	if (node->type == NODE4) {
+
+		Node4 *small = static_cast<Node4 *>(node);
+		Node16 *medium = new Node16();
+
+		memcpy(medium->keys, small->keys, 4);
+		memcpy(medium->children, small->children, 4 * sizeof(Node *));
+		bigger = medium;
+		bigger->type = NODE16;
+		nodes[NODE4]--;
+		nodes[NODE16]++;
+	}
+	else if (node->type == NODE16) {
+
+		Node16 *medium = static_cast<Node16 *>(node);
+		Node48 *large = new Node48();
+
+		for (int i = 0; i < 16; i++) {
+
+			large->children[i] = medium->children[i];
+			large->index[medium->keys[i]] = (uint8_t)(i + 1);
+		}
+
+		bigger = large;
+		bigger->type = NODE48;
+		nodes[NODE16]--;
+		nodes[NODE48]++;
+	}
+	else {
+
+		Node48 *large = static_cast<Node48 *>(node);
+		Node256 *full = new Node256();
+
+		for (int byte = 0; byte < 256; byte++) {
+
+			if (large->index[byte] != 0) {
+
+				full->children[byte] = large->children[large->index[byte] - 1];
+			}
+		}
+
+		bigger = full;
+		bigger->type = NODE256;
+		nodes[NODE48]--;
+		nodes[NODE256]++;
+	}
+
+	bigger->terminal = node->terminal;
+	bigger->count = node->count;
+	bigger->prefixLength = node->prefixLength;
+	bigger->prefixOffset = node->prefixOffset;
+
+	switch (node->type) {
+
+	case NODE4:
+		delete static_cast<Node4 *>(node);
+		break;
+	case NODE16:
+		delete static_cast<Node16 *>(node);
+		break;
+	default:
+		delete static_cast<Node48 *>(node);
+	}
+
+	*ref = bigger;
+}
+
+
+/**
+ * Number of leading characters of the node's prefix that match word
+ * starting at depth
+ */
+size_t RadixTree::matchPrefix(const Node *node, string_view word,
+	size_t depth) const
+{
+	string_view path = arena.view(node->prefixOffset, node->prefixLength);
+	size_t limit = std::min(path.size(), word.size() - depth);
+	size_t matched = 0;
+
+	while (matched < limit && path[matched] == word[depth + matched]) {
+
+		matched++;
+	}
+
+	return matched;
+}
+
+
+/**
+ * Visits every word at or below node in byte order. word holds the
+ * characters up to and including node's prefix.
+ */
+void RadixTree::enumerate(const Node *node, string& word,
+	const std::function<void(string_view)>& visit) const
+{
+	if (node->terminal) {
+
+		visit(word);
+	}
+
+	size_t length = word.size();
+	auto descend = [&](uint8_t byte, const Node *child) {
+
+		word.push_back((char)byte);
+		word.append(arena.view(child->prefixOffset, child->prefixLength));
+		enumerate(child, word, visit);
+		word.resize(length);
+	};
+
+	switch (node->type) {
+
+	case NODE4: {
+
+		const Node4 *small = static_cast<const Node4 *>(node);
+
+		for (int i = 0; i < small->count; i++) {
+
+			descend(small->keys[i], small->children[i]);
+		}
+
+		break;
+	}
+
+	case NODE16: {
+
+		const Node16 *medium = static_cast<const Node16 *>(node);
+
+		for (int i = 0; i < medium->count; i++) {
+
+			descend(medium->keys[i], medium->children[i]);
+		}
+
+		break;
+	}
+
+	case NODE48: {
+
+		const Node48 *large = static_cast<const Node48 *>(node);
+
+		for (int byte = 0; byte < 256; byte++) {
+
+			if (large->index[byte] != 0) {
+
+				descend((uint8_t)byte, large->children[large->index[byte] - 1]);
+			}
+		}
+
+		break;
+	}
+
+	default: {
+
+		const Node256 *full = static_cast<const Node256 *>(node);
+
+		for (int byte = 0; byte < 256; byte++) {
+
+			if (full->children[byte] != nullptr) {
+
+				descend((uint8_t)byte, full->children[byte]);
+			}
+		}
+	}
+	}
+}
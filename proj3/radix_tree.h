@@ -0,0 +1,110 @@
+/**
+ * @file radix_tree.h - Declaration of the adaptive radix tree dictionary
+ * that answers prefix queries over a word list.
+ *
+ * @brief - Each node consumes one byte of the key and picks its child
+ * from a node type sized to its fan-out: up to 4 children in a sorted
+ * array, up to 16 in a sorted array searched with one SSE2 compare, up
+ * to 48 through a 256-entry byte index, and 256 in a direct table. Runs
+ * of single-child nodes are compressed into a prefix stored in the node,
+ * so a word costs about one node. Children are kept in byte order, which
+ * makes prefix enumeration come out sorted.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __RADIX_TREE_H
+#define __RADIX_TREE_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <functional>
+#include <cstdint>
+#include <cstddef>
+#include "string_arena.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+class RadixTree {
+
+public:
+	RadixTree();
+	~RadixTree();
+
+	RadixTree(const RadixTree&) = delete;
+	RadixTree& operator=(const RadixTree&) = delete;
+
+	bool insert(string_view word);           // false if already present
+	bool search(string_view word) const;     // exact lookup
+	bool loadFile(string filename);          // insert every word of a file
+
+	// visit every stored word starting with prefix, in sorted order
+	void forEachPrefixed(string_view prefix,
+		const std::function<void(string_view)>& visit) const;
+	vector<string> startingWith(string_view prefix) const;
+
+	// longest stored word that is a prefix of text
+	bool longestPrefix(string_view text, string_view& match) const;
+
+	size_t size() const;
+	size_t nodeCount(int type) const;        // nodes of type 4, 16, 48, 256
+	size_t memoryUsage() const;
+
+private:
+	enum { NODE4, NODE16, NODE48, NODE256 };
+
+	struct Node {
+
+		uint8_t type;
+		uint8_t terminal;            // a word ends after the prefix
+		uint16_t count;              // number of children
+		uint32_t prefixLength;       // compressed path, in the arena
+		uint32_t prefixOffset;
+	};
+
+	struct Node4 : Node {
+
+		uint8_t keys[4];
+		Node *children[4];
+	};
+
+	struct Node16 : Node {
+
+		alignas(16) uint8_t keys[16];
+		Node *children[16];
+	};
+
+	struct Node48 : Node {
+
+		uint8_t index[256];          // child slot + 1, 0 when absent
+		Node *children[48];
+	};
+
+	struct Node256 : Node {
+
+		Node *children[256];
+	};
+
+	Node *root;
+	StringArena arena;
+	size_t words;
+	size_t nodes[4];
+
+	Node *makeLeaf(string_view suffix);
+	Node4 *makeNode4(uint32_t prefixOffset, uint32_t prefixLength);
+	void release(Node *node);
+
+	static Node **findChild(Node *node, uint8_t byte);
+	void addChild(Node **ref, uint8_t byte, Node *child);
+	void grow(Node **ref);
+
+	size_t matchPrefix(const Node *node, string_view word, size_t depth) const;
+	void enumerate(const Node *node, string& word,
+		const std::function<void(string_view)>& visit) const;
+};
+
+#endif
@@ -0,0 +1,108 @@
+/**
+ * @file short_key.h - Packed representation of keys of at most sixteen
+ * characters.
+ *
+ * @brief - A short key is copied into a zero padded sixteen byte slot.
+ * Two packed keys of the same length are equal exactly when their slots
+ * are, which a single SSE2 compare decides, and the slot read as two
+ * 64-bit integers is hashed with a fixed number of multiplies instead of
+ * a loop over the characters. A key of at most eight characters only
+ * needs the low half of its slot, so it is stored in eight bytes and
+ * compared as one 64-bit integer.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __SHORT_KEY_H
+#define __SHORT_KEY_H
+
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include "hash_mix.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using std::string_view;
+
+static const size_t SHORT_KEY = 16;      // longest key that is packed
+static const size_t TINY_KEY = 8;        // longest key stored in 8 bytes
+
+/**
+ * Bytes a packed key takes where it is stored
+ *
+ * @param length - Number of characters, at most SHORT_KEY
+ */
+inline size_t packedSize(size_t length)
+{
+	return length <= TINY_KEY ? TINY_KEY : SHORT_KEY;
+}
+
+
+/**
+ * Copies word into a zero padded slot
+ *
+ * @param word - At most SHORT_KEY characters
+ * @param slot - SHORT_KEY bytes to fill
+ */
+inline void packKey(string_view word, char *slot)
+{
+	memset(slot, 0, SHORT_KEY);
+	memcpy(slot, word.data(), word.size());
+}
+
+
+/**
+ * True when two packed keys of the same length hold the same bytes
+ *
+ * @param a - packedSize(length) readable bytes
+ * @param b - packedSize(length) readable bytes
+ * @param length - Number of characters in both keys
+ */
+inline bool packedEqual(const char *a, const char *b, size_t length)
+{
+	if (length <= TINY_KEY) {
+
+		uint64_t left;
+		uint64_t right;
+
+		memcpy(&left, a, TINY_KEY);
+		memcpy(&right, b, TINY_KEY);
+
+		return left == right;
+	}
+
+#ifdef __SSE2__
+	__m128i left = _mm_loadu_si128((const __m128i *)a);
+	__m128i right = _mm_loadu_si128((const __m128i *)b);
+
+	return _mm_movemask_epi8(_mm_cmpeq_epi8(left, right)) == 0xFFFF;
+#else
+	return memcmp(a, b, SHORT_KEY) == 0;
+#endif
+}
+
+
+/**
+ * Hashes a packed slot as two 64-bit words
+ *
+ * @param slot - Packed key
+ * @param length - Number of characters in the key, so keys ending in
+ * zero bytes differ from shorter ones
+ */
+inline uint64_t hashPacked(const char *slot, size_t length)
+{
+	uint64_t low;
+	uint64_t high;
+
+	memcpy(&low, slot, 8);
+	memcpy(&high, slot + 8, 8);
+
+	return mix64(low * 0x9e3779b97f4a7c15ULL
+		^ (high + length) * 0xc2b2ae3d27d4eb4fULL);
+}
+
+#endif
@@ -0,0 +1,393 @@
+/**
+ * @file static_hash.cpp - Construction, lookup and persistence of the
+ * minimal perfect hash dictionary.
+ *
+ * @brief - Buckets are placed largest first while the table is still
+ * mostly empty. For each bucket the pilots 0, 1, 2, ... are tried until
+ * every key of the bucket lands on a distinct free slot. If some bucket
+ * cannot be placed (two keys with the same 64-bit hash) the whole build
+ * is retried with another seed.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include "static_hash.h"
+#include "hash_mix.h"
+#include "word_loader.h"
+
+using std::ofstream;
+using std::sort;
+using std::unique;
+
+static const char STATIC_HASH_MAGIC[8] = { 'P', 'H', 'A', 'S', 'H', '3', '\0', '\0' };
+static const uint32_t STATIC_HASH_VERSION = 1;
+static const int STATIC_HASH_ATTEMPTS = 16;
+
+
+/**
+ * Constructor
+ *
+ * Starts as an empty dictionary, every search fails.
+ */
+StaticHash::StaticHash()
+{
+	reset();
+}
+
+
+/**
+ * Forgets the current dictionary, built or loaded
+ */
+void StaticHash::reset()
+{
+	ownPilots.clear();
+	ownOffsets.assign(1, 0);
+	ownHeap.clear();
+	mapping.close();
+
+	pilots = nullptr;
+	offsets = ownOffsets.data();
+	heap = nullptr;
+	keyCount = 0;
+	bucketCount = 0;
+	seed = 0;
+}
+
+
+/**
+ * Slot of a key given its hash and the pilot of its bucket
+ *
+ * @param hash - hashBytes(key, seed)
+ * @param pilot - Pilot of the key's bucket
+ */
+uint32_t StaticHash::slotOf(uint64_t hash, uint32_t pilot) const
+{
+	return (uint32_t)((hash ^ mix64(pilot + seed)) % keyCount);
+}
+
+
+/**
+ * Builds the dictionary over keys. Duplicates are ignored.
+ *
+ * @param keys - Keys to store, copied into the dictionary
+ *
+ * @return false if no seed produced a perfect placement
+ */
+bool StaticHash::build(vector<string_view> keys)
+{
+	reset();
+
+	sort(keys.begin(), keys.end());
+	keys.erase(unique(keys.begin(), keys.end()), keys.end());
+
+	if (keys.empty()) {
+
+		return true;
+	}
+
+	keyCount = (uint32_t)keys.size();
+	bucketCount = keyCount / 4 + 1;
+
+	for (int attempt = 0; attempt < STATIC_HASH_ATTEMPTS; attempt++) {
+
+		if (place(keys, mix64(attempt + 1))) {
+
+			return true;
+		}
+	}
+
+	reset();
+
+	return false;
+}
+
+
+/**
+ * Builds the dictionary over every word of a word file
+ *
+ * @param filename - Name of the word file
+ *
+ * @return false if the file could not be read or the build failed
+ */
+bool StaticHash::buildFromFile(string filename)
+{
+	MappedFile file;
+
+	if (!file.open(filename)) {
+
+		return false;
+	}
+
+	vector<string_view> keys;
+
+	forEachWord(file.data(), file.size(), [&keys](string_view word) {
+
+		keys.push_back(word);
+	});
+
+	return build(keys);
+}
+
+
+/**
+ * Tries to place every key with the given seed
+ *
+ * @param keys - Distinct keys
+ * @param trySeed - Seed of the hash function
+ *
+ * @return false if some bucket had no valid pilot
+ */
+bool StaticHash::place(const vector<string_view>& keys, uint64_t trySeed)
+{
+	seed = trySeed;
+
+	vector<uint64_t> hashes(keyCount);
+	vector<uint32_t> bucketStart(bucketCount + 1, 0);
+
+	for (uint32_t i = 0; i < keyCount; i++) {
+
+		hashes[i] = hashBytes(keys[i], seed);
+		bucketStart[bucketOf(hashes[i]) + 1]++;
+	}
+
+	uint32_t largest = 0;
+
+	for (uint32_t b = 0; b < bucketCount; b++) {
+
+		largest = std::max(largest, bucketStart[b + 1]);
+		bucketStart[b + 1] += bucketStart[b];
+	}
+
+	// keys grouped by bucket
+	vector<uint32_t> members(keyCount);
+	vector<uint32_t> fill(bucketStart.begin(), bucketStart.end() - 1);
+
+	for (uint32_t i = 0; i < keyCount; i++) {
+
+		members[fill[bucketOf(hashes[i])]++] = i;
+	}
+
+	// buckets from largest to smallest
+	vector<uint32_t> sizeStart(largest + 2, 0);
+
+	for (uint32_t b = 0; b < bucketCount; b++) {
+
+		sizeStart[largest - (bucketStart[b + 1] - bucketStart[b]) + 1]++;
+	}
+
+	for (uint32_t s = 0; s <= largest; s++) {
+
+		sizeStart[s + 1] += sizeStart[s];
+	}
+
+	vector<uint32_t> order(bucketCount);
+
+	for (uint32_t b = 0; b < bucketCount; b++) {
+
+		order[sizeStart[largest - (bucketStart[b + 1] - bucketStart[b])]++] = b;
+	}
+
+	vector<bool> taken(keyCount, false);
+	vector<uint32_t> keyInSlot(keyCount);
+	vector<uint32_t> positions;
+	uint64_t limit = 16 * (uint64_t)keyCount + 1024;
+
+	ownPilots.assign(bucketCount, 0);
+
+	for (uint32_t b : order) {
+
+		uint32_t first = bucketStart[b];
+		uint32_t last = bucketStart[b + 1];
+
+		if (first == last) {
+
+			break;
+		}
+
+		for (uint64_t pilot = 0; ; pilot++) {
+
+			if (pilot > limit) {
+
+				return false;
+			}
+
+			positions.clear();
+
+			for (uint32_t m = first; m < last; m++) {
+
+				uint32_t slot = slotOf(hashes[members[m]], (uint32_t)pilot);
+
+				if (taken[slot] || std::find(positions.begin(), positions.end(),
+					slot) != positions.end()) {
+
+					break;
+				}
+
+				positions.push_back(slot);
+			}
+
+			if (positions.size() == last - first) {
+
+				for (uint32_t m = first; m < last; m++) {
+
+					taken[positions[m - first]] = true;
+					keyInSlot[positions[m - first]] = members[m];
+				}
+
+				ownPilots[b] = (uint32_t)pilot;
+				break;
+			}
+		}
+	}
+
+	ownOffsets.assign(keyCount + 1, 0);
+	ownHeap.clear();
+
+	for (uint32_t s = 0; s < keyCount; s++) {
+
+		string_view key = keys[keyInSlot[s]];
+
+		ownHeap.insert(ownHeap.end(), key.begin(), key.end());
+		ownOffsets[s + 1] = (uint32_t)ownHeap.size();
+	}
+
+	pilots = ownPilots.data();
+	offsets = ownOffsets.data();
+	heap = ownHeap.data();
+
+	return true;
+}
+
+
+/**
+ * Membership test: the key can only live in one slot
+ *
+ * @param word - Key we are searching for
+ */
+bool StaticHash::search(string_view word) const
+{
+	if (keyCount == 0) {
+
+		return false;
+	}
+
+	uint64_t hash = hashBytes(word, seed);
+	uint32_t slot = slotOf(hash, pilots[bucketOf(hash)]);
+	uint32_t begin = offsets[slot];
+
+	return offsets[slot + 1] - begin == word.size()
+		&& memcmp(heap + begin, word.data(), word.size()) == 0;
+}
+
+
+/**
+ * Writes the dictionary in the layout described by Header
+ *
+ * @param filename - Name of the output file
+ *
+ * @return false if the file could not be written
+ */
+bool StaticHash::save(string filename) const
+{
+	Header header;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, STATIC_HASH_MAGIC, sizeof(header.magic));
+	header.version = STATIC_HASH_VERSION;
+	header.keyCount = keyCount;
+	header.bucketCount = bucketCount;
+	header.seed = seed;
+	header.heapSize = offsets[keyCount];
+
+	ofstream output_file(filename, std::ios::binary | std::ios::trunc);
+
+	output_file.write((const char *)&header, sizeof(header));
+	output_file.write((const char *)pilots, bucketCount * sizeof(uint32_t));
+	output_file.write((const char *)offsets, (keyCount + 1) * sizeof(uint32_t));
+	output_file.write(heap, header.heapSize);
+
+	return output_file.good();
+}
+
+
+/**
+ * Maps a dictionary written by save. Nothing is copied, the pilots,
+ * offsets and keys are read in place from the mapping.
+ *
+ * @param filename - Name of the saved dictionary
+ *
+ * @return false if the file is missing, truncated, not a dictionary or
+ * has key offsets outside its heap
+ */
+bool StaticHash::load(string filename)
+{
+	reset();
+
+	if (!mapping.open(filename) || mapping.size() < sizeof(Header)) {
+
+		reset();
+		return false;
+	}
+
+	const Header *header = (const Header *)mapping.data();
+	uint64_t expected = sizeof(Header)
+		+ (uint64_t)header->bucketCount * sizeof(uint32_t)
+		+ ((uint64_t)header->keyCount + 1) * sizeof(uint32_t)
+		+ header->heapSize;
+
+	if (memcmp(header->magic, STATIC_HASH_MAGIC, sizeof(header->magic)) != 0
+		|| header->version != STATIC_HASH_VERSION
+		|| expected != mapping.size()
+		|| (header->keyCount > 0 && header->bucketCount == 0)) {
+
+		reset();
+		return false;
+	}
+
+	keyCount = header->keyCount;
+	bucketCount = header->bucketCount;
+	seed = header->seed;
+
+	pilots = (const uint32_t *)(mapping.data() + sizeof(Header));
+	offsets = pilots + bucketCount;
+	heap = (const char *)(offsets + keyCount + 1);
+
+	// search trusts the offsets, so every key has to lie inside the heap
+	bool inside = offsets[0] == 0 && offsets[keyCount] == header->heapSize;
+
+	for (uint32_t s = 0; inside && s < keyCount; s++) {
+
+		inside = offsets[s] <= offsets[s + 1];
+	}
+
+	if (!inside) {
+
+		reset();
+		return false;
+	}
+
+	return true;
+}
+
+
+/**
+ * Number of distinct keys in the dictionary
+ */
+size_t StaticHash::size() const
+{
+	return keyCount;
+}
+
+
+/**
+ * Bytes needed by the lookup structures and the keys themselves
+ */
+size_t StaticHash::memoryUsage() const
+{
+	return bucketCount * sizeof(uint32_t)
+		+ (keyCount + 1) * sizeof(uint32_t) + offsets[keyCount];
+}
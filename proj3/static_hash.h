@@ -0,0 +1,81 @@
+/**
+ * @file static_hash.h - Declaration of the build-once, read-only
+ * dictionary backed by a minimal perfect hash function.
+ *
+ * @brief - Keys are hashed into small buckets and every bucket gets a
+ * pilot value, chosen at build time, that sends all of its keys to free
+ * slots (PTHash/CHD style). Every key owns exactly one slot of a table of
+ * exactly n slots, so a lookup is one hash, one pilot read and one key
+ * compare. The built dictionary can be saved to disk and mapped back
+ * with load(), in which case lookups read straight from the mapping.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __STATIC_HASH_H
+#define __STATIC_HASH_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include "mapped_file.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+class StaticHash {
+
+public:
+	StaticHash();
+	bool build(vector<string_view> keys);    // build over a set of keys
+	bool buildFromFile(string filename);     // build over a word file
+	bool search(string_view word) const;     // one probe membership test
+	bool save(string filename) const;        // write the built structure
+	bool load(string filename);              // map a saved structure
+	size_t size() const;                     // number of distinct keys
+	size_t memoryUsage() const;              // bytes of pilots, offsets, keys
+
+	/**
+	 * Layout of a saved dictionary. The header is followed by
+	 * bucketCount pilots, keyCount + 1 key offsets and the key heap.
+	 */
+	struct Header {
+
+		char magic[8];
+		uint32_t version;
+		uint32_t keyCount;
+		uint32_t bucketCount;
+		uint32_t reserved;
+		uint64_t seed;
+		uint64_t heapSize;
+	};
+
+private:
+	vector<uint32_t> ownPilots;      // storage when built in memory
+	vector<uint32_t> ownOffsets;
+	vector<char> ownHeap;
+	MappedFile mapping;              // storage when loaded from disk
+
+	const uint32_t *pilots;          // pilot of every bucket
+	const uint32_t *offsets;         // key in slot i is heap[offsets[i]..[i+1])
+	const char *heap;
+	uint32_t keyCount;
+	uint32_t bucketCount;
+	uint64_t seed;
+
+	bool place(const vector<string_view>& keys, uint64_t trySeed);
+	void reset();
+
+	uint32_t bucketOf(uint64_t hash) const
+	{
+		return (uint32_t)((hash >> 32) % bucketCount);
+	}
+
+	uint32_t slotOf(uint64_t hash, uint32_t pilot) const;
+};
+
+#endif
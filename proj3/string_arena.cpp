@@ -0,0 +1,207 @@
+/**
+ * @file string_arena.cpp - Bump-pointer allocation of key characters.
+ *
+ * @brief - The arena only ever grows. Removing a key from the table leaves
+ * its characters behind; the owner reports them with release() and, once
+ * enough bytes are dead, copies its live keys into a fresh arena. Offsets
+ * are 32 bits, interning past 4 GiB throws std::length_error instead of
+ * handing out an offset that wraps.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <cstring>
+#include <cstdint>
+#include <stdexcept>
+#include "string_arena.h"
+#include "short_key.h"
+
+/**
+ * Constructor
+ *
+ * Starts with an empty buffer, the first intern allocates.
+ */
+StringArena::StringArena()
+{
+	used = 0;
+	allocated = 0;
+	dead = 0;
+}
+
+
+/**
+ * Copies word to the end of the arena
+ *
+ * @param word - Characters to store
+ *
+ * @return offset of the first character, to be used with view()
+ */
+unsigned int StringArena::intern(string_view word)
+{
+	checkOffset(used + word.size());
+
+	if (used + word.size() > allocated) {
+
+		grow(used + word.size());
+	}
+
+	unsigned int offset = (unsigned int)used;
+
+	if (!word.empty()) {
+
+		memcpy(buffer.get() + used, word.data(), word.size());
+		used += word.size();
+	}
+
+	return offset;
+}
+
+
+/**
+ * Copies a key of at most SHORT_KEY characters into a zero padded, 8-byte
+ * aligned slot of its own, so it can be compared as one block. Keys of at
+ * most TINY_KEY characters get an 8-byte slot, longer ones 16; aligning
+ * both to 8 means a run of packed keys leaves no padding between them.
+ *
+ * @param word - Characters to store
+ *
+ * @return offset of the slot, to be used with view()
+ */
+unsigned int StringArena::internPacked(string_view word)
+{
+	size_t slot = packedSize(word.size());
+	size_t start = (used + TINY_KEY - 1) & ~(TINY_KEY - 1);
+
+	checkOffset(start + slot);
+
+	if (start + slot > allocated) {
+
+		grow(start + slot);
+	}
+
+	memset(buffer.get() + start, 0, slot);
+	memcpy(buffer.get() + start, word.data(), word.size());
+	used = start + slot;
+
+	return (unsigned int)start;
+}
+
+
+/**
+ * Makes sure bytes more characters can be interned without reallocating.
+ * The buffer is sized exactly, a caller that knows what it will intern
+ * pays for no geometric slack.
+ *
+ * @param bytes - Number of characters about to be interned
+ */
+void StringArena::reserve(size_t bytes)
+{
+	if (used + bytes > allocated) {
+
+		reallocate(used + bytes);
+	}
+}
+
+
+/**
+ * Records that bytes handed out earlier are no longer referred to. The
+ * characters stay where they are, this only feeds released().
+ *
+ * @param bytes - Size of the slot that was given up
+ */
+void StringArena::release(size_t bytes)
+{
+	dead += bytes;
+}
+
+
+/**
+ * Forgets every interned string, keeping the buffer for reuse
+ */
+void StringArena::clear()
+{
+	used = 0;
+	dead = 0;
+}
+
+
+/**
+ * Number of bytes handed out by intern
+ */
+size_t StringArena::size() const
+{
+	return used;
+}
+
+
+/**
+ * Number of bytes handed out and then given back with release
+ */
+size_t StringArena::released() const
+{
+	return dead;
+}
+
+
+/**
+ * Number of bytes currently allocated
+ */
+size_t StringArena::capacity() const
+{
+	return allocated;
+}
+
+
+/**
+ * Reallocates the buffer to at least needed bytes. Growth is geometric
+ * so a long run of interns costs amortized O(1) per byte.
+ *
+ * @param needed - Minimum size of the new buffer
+ */
+void StringArena::grow(size_t needed)
+{
+	size_t bigger = allocated < 4096 ? 4096 : allocated * 2;
+
+	while (bigger < needed) {
+
+		bigger *= 2;
+	}
+
+	reallocate(bigger);
+}
+
+
+/**
+ * Moves the interned characters into a new buffer of exactly bytes bytes.
+ * Offsets stay valid since they are relative to the start of the buffer.
+ *
+ * @param bytes - Size of the new buffer, at least size()
+ */
+void StringArena::reallocate(size_t bytes)
+{
+	std::unique_ptr<char[]> replacement(new char[bytes]);
+
+	if (used > 0) {
+
+		memcpy(replacement.get(), buffer.get(), used);
+	}
+
+	buffer.swap(replacement);
+	allocated = bytes;
+}
+
+
+/**
+ * Throws std::length_error if a string ending at end could not be found
+ * again through a 32-bit offset
+ *
+ * @param end - One past the last byte the string would occupy
+ */
+void StringArena::checkOffset(size_t end)
+{
+	if (end > UINT32_MAX) {
+
+		throw std::length_error("string arena is limited to 4 GiB");
+	}
+}
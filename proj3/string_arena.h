@@ -0,0 +1,72 @@
+/**
+ * @file string_arena.h - Declaration of the bump-pointer string arena
+ * that holds the characters of every key stored in the hash table.
+ *
+ * @brief - Keys are appended back to back into one growing buffer and
+ * referred to by (offset, length), so the table never owns a separate
+ * heap string per key. Offsets are 32 bits, an arena holds at most 4 GiB.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __STRING_ARENA_H
+#define __STRING_ARENA_H
+
+#include <string_view>
+#include <memory>
+#include <cstddef>
+
+using std::string_view;
+
+/**
+ * Compact description of one key stored in a StringArena
+ */
+struct KeyRecord {
+
+	unsigned int offset;             // first character in the arena
+	unsigned int length;             // number of characters
+	unsigned int hash;               // full hash of the key
+};
+
+class StringArena {
+
+public:
+	StringArena();
+	unsigned int intern(string_view word);   // copy word, return its offset
+	unsigned int internPacked(string_view word);  // 8 or 16-byte padded slot
+	void reserve(size_t bytes);              // make room for bytes more
+	void release(size_t bytes);              // mark bytes as no longer used
+	void clear();                            // drop every interned string
+	size_t size() const;                     // bytes handed out so far
+	size_t released() const;                 // bytes handed out then released
+	size_t capacity() const;                 // bytes allocated
+
+	/**
+	 * Returns the characters of a key previously interned
+	 *
+	 * @param offset - Offset returned by intern
+	 * @param length - Length of the interned word
+	 */
+	string_view view(unsigned int offset, unsigned int length) const
+	{
+		return string_view(buffer.get() + offset, length);
+	}
+
+	string_view view(const KeyRecord& record) const
+	{
+		return view(record.offset, record.length);
+	}
+
+private:
+	std::unique_ptr<char[]> buffer;
+	size_t used;                     // bump pointer into buffer
+	size_t allocated;                // size of buffer
+	size_t dead;                     // released bytes still in buffer
+
+	void grow(size_t needed);
+	void reallocate(size_t bytes);
+	static void checkOffset(size_t end);
+};
+
+#endif
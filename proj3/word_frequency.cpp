@@ -0,0 +1,442 @@
+/**
+ * @file word_frequency.cpp - Exact, sketched and top-k counting of a word
+ * stream.
+ *
+ * @brief - Each word is hashed once; the same 64-bit value picks the
+ * sketch counters and locates the word in the tracked table and in the
+ * SpaceSaving index. The sketch uses conservative update, raising only
+ * the counters that are at the current minimum, which keeps the estimates
+ * of light words much closer to their true counts.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "word_frequency.h"
+#include "hash_mix.h"
+#include "mapped_file.h"
+#include "word_loader.h"
+
+static const uint64_t SEED = 0x5bd1e9955bd1e995ULL;
+
+
+/**
+ * Constructor
+ *
+ * @param epsilon - Estimates overcount by at most epsilon * total words
+ * @param delta - Probability that an estimate misses that bound
+ * @param topK - Number of heavy hitters to follow
+ */
+WordFrequency::WordFrequency(double epsilon, double delta, size_t topK)
+	: tracked(16, TrackedHash(), TrackedEqual{&arena}),
+	slotIndex(topK * 2 + 1, SlotHash{&slots}, SlotEqual{&slots})
+{
+	size_t wanted = 2;
+
+	while (wanted < std::exp(1.0) / epsilon) {
+
+		wanted *= 2;
+	}
+
+	rowMask = wanted - 1;
+	rows = std::max(1, (int)std::ceil(std::log(1.0 / delta)));
+	sketch.assign(rows * wanted, 0);
+	words = 0;
+
+	// slots must never move, the index and heap refer to them by number
+	// and short words keep their characters inside the string object
+	capacity = std::max<size_t>(topK, 1);
+	slots.reserve(capacity);
+	heap.reserve(capacity);
+}
+
+
+/**
+ * Counts one occurrence of word in every structure
+ *
+ * @param word - Word to count
+ */
+void WordFrequency::add(string_view word)
+{
+	WordQuery key = query(word);
+
+	words++;
+	addToSketch(key.hash);
+
+	if (!tracked.empty()) {
+
+		auto it = tracked.find(key);
+
+		if (it != tracked.end()) {
+
+			it->second++;
+		}
+	}
+
+	addToSummary(key);
+}
+
+
+/**
+ * Counts every word of a file, read through a read-only mapping
+ *
+ * @param filename - File of whitespace separated words
+ *
+ * @return false if the file could not be opened
+ */
+bool WordFrequency::processFile(string filename)
+{
+	MappedFile file;
+
+	if (!file.open(filename)) {
+
+		return false;
+	}
+
+	forEachWord(file.data(), file.size(), [this](string_view word) {
+
+		add(word);
+	});
+
+	return true;
+}
+
+
+/**
+ * Starts counting word exactly. Occurrences added before the call are not
+ * part of its exact count.
+ *
+ * @param word - Word to track
+ */
+void WordFrequency::track(string_view word)
+{
+	WordQuery key = query(word);
+
+	if (tracked.find(key) != tracked.end()) {
+
+		return;
+	}
+
+	KeyRecord record;
+
+	record.offset = arena.intern(word);
+	record.length = (unsigned int)word.size();
+	record.hash = (unsigned int)key.hash;
+
+	tracked.try_emplace(record, 0);
+}
+
+
+/**
+ * Frequency of word: the exact count for tracked words, the smaller of the
+ * SpaceSaving bound and the sketch estimate otherwise
+ *
+ * @param word - Word to look up
+ */
+uint64_t WordFrequency::count(string_view word) const
+{
+	WordQuery key = query(word);
+	auto it = tracked.find(key);
+
+	if (it != tracked.end()) {
+
+		return it->second;
+	}
+
+	uint64_t estimate = sketchMinimum(key.hash);
+	auto slot = slotIndex.find(key);
+
+	if (slot != slotIndex.end()) {
+
+		estimate = std::min(estimate, slots[slot->first].count);
+	}
+
+	return estimate;
+}
+
+
+/**
+ * Count-Min estimate of the frequency of word. Never less than the true
+ * count.
+ *
+ * @param word - Word to look up
+ */
+uint64_t WordFrequency::estimate(string_view word) const
+{
+	return sketchMinimum(query(word).hash);
+}
+
+
+/**
+ * Looks up the exact count of a tracked word
+ *
+ * @param word - Word to look up
+ * @param count - Set to the number of occurrences since track(word)
+ *
+ * @return false if word is not tracked
+ */
+bool WordFrequency::exact(string_view word, uint64_t& count) const
+{
+	auto it = tracked.find(query(word));
+
+	if (it == tracked.end()) {
+
+		return false;
+	}
+
+	count = it->second;
+
+	return true;
+}
+
+
+/**
+ * Returns the words currently followed by the SpaceSaving summary, highest
+ * count first. Any word occurring more than total() / k times is in it.
+ */
+vector<HeavyHitter> WordFrequency::topK() const
+{
+	vector<HeavyHitter> result;
+
+	result.reserve(slots.size());
+
+	for (const Slot& slot : slots) {
+
+		result.push_back({ slot.word, slot.count, slot.error });
+	}
+
+	std::sort(result.begin(), result.end(),
+		[](const HeavyHitter& a, const HeavyHitter& b) {
+
+		return a.count != b.count ? a.count > b.count : a.word < b.word;
+	});
+
+	return result;
+}
+
+
+/**
+ * Number of words added
+ */
+uint64_t WordFrequency::total() const
+{
+	return words;
+}
+
+
+/**
+ * Number of counters in each sketch row
+ */
+size_t WordFrequency::width() const
+{
+	return rowMask + 1;
+}
+
+
+/**
+ * Number of sketch rows, each an independent estimate
+ */
+size_t WordFrequency::depth() const
+{
+	return rows;
+}
+
+
+/**
+ * Bytes held by the sketch, the summary and the tracked table
+ */
+size_t WordFrequency::memoryUsage() const
+{
+	size_t bytes = sketch.capacity() * sizeof(uint32_t)
+		+ slots.capacity() * sizeof(Slot)
+		+ heap.capacity() * sizeof(unsigned int)
+		+ slotIndex.memoryUsage() + tracked.memoryUsage()
+		+ arena.capacity();
+
+	for (const Slot& slot : slots) {
+
+		if (slot.word.capacity() > sizeof(string) - 1) {
+
+			bytes += slot.word.capacity() + 1;
+		}
+	}
+
+	return bytes;
+}
+
+
+/**
+ * Hashes word once for every structure
+ *
+ * @param word - Word to hash
+ */
+WordFrequency::WordQuery WordFrequency::query(string_view word) const
+{
+	return WordQuery{ word, hashBytes(word, SEED) };
+}
+
+
+/**
+ * Conservative update: only counters equal to the current minimum are
+ * raised, since the others already overcount
+ *
+ * @param hash - Hash of the word
+ */
+void WordFrequency::addToSketch(uint64_t hash)
+{
+	uint32_t least = UINT32_MAX;
+
+	for (size_t row = 0; row < rows; row++) {
+
+		least = std::min(least, sketch[counterOf(hash, row)]);
+	}
+
+	if (least == UINT32_MAX) {
+
+		return;
+	}
+
+	for (size_t row = 0; row < rows; row++) {
+
+		uint32_t& counter = sketch[counterOf(hash, row)];
+
+		if (counter == least) {
+
+			counter++;
+		}
+	}
+}
+
+
+/**
+ * Smallest counter of the word's row entries, its Count-Min estimate
+ *
+ * @param hash - Hash of the word
+ */
+uint64_t WordFrequency::sketchMinimum(uint64_t hash) const
+{
+	uint32_t least = UINT32_MAX;
+
+	for (size_t row = 0; row < rows; row++) {
+
+		least = std::min(least, sketch[counterOf(hash, row)]);
+	}
+
+	return least;
+}
+
+
+/**
+ * SpaceSaving: a followed word is incremented, a new word takes a free
+ * slot, or else replaces the word with the smallest count and inherits
+ * that count as its error
+ *
+ * @param key - Word and its hash
+ */
+void WordFrequency::addToSummary(const WordQuery& key)
+{
+	auto it = slotIndex.find(key);
+
+	if (it != slotIndex.end()) {
+
+		Slot& slot = slots[it->first];
+
+		slot.count++;
+		siftDown(slot.heapPos);
+
+		return;
+	}
+
+	unsigned int index;
+
+	if (slots.size() < capacity) {
+
+		index = (unsigned int)slots.size();
+		slots.push_back(Slot{ string(key.word), key.hash, 1, 0,
+			(unsigned int)heap.size() });
+		heap.push_back(index);
+		siftUp(slots[index].heapPos);
+	}
+	else {
+
+		index = heap[0];
+		slotIndex.erase(index);
+
+		Slot& slot = slots[index];
+
+		slot.word.assign(key.word.data(), key.word.size());
+		slot.hash = key.hash;
+		slot.error = slot.count;
+		slot.count++;
+		siftDown(0);
+	}
+
+	slotIndex.try_emplace(index, 0);
+}
+
+
+/**
+ * Moves the heap entry at position down until its count is no larger than
+ * its children's
+ *
+ * @param position - Heap position whose count grew
+ */
+void WordFrequency::siftDown(unsigned int position)
+{
+	unsigned int size = (unsigned int)heap.size();
+
+	while (true) {
+
+		unsigned int smallest = position;
+		unsigned int left = 2 * position + 1;
+		unsigned int right = left + 1;
+
+		if (left < size && slots[heap[left]].count
+			< slots[heap[smallest]].count) {
+
+			smallest = left;
+		}
+
+		if (right < size && slots[heap[right]].count
+			< slots[heap[smallest]].count) {
+
+			smallest = right;
+		}
+
+		if (smallest == position) {
+
+			return;
+		}
+
+		std::swap(heap[position], heap[smallest]);
+		slots[heap[position]].heapPos = position;
+		slots[heap[smallest]].heapPos = smallest;
+		position = smallest;
+	}
+}
+
+
+/**
+ * Moves the heap entry at position up past parents with larger counts
+ *
+ * @param position - Heap position of a new entry
+ */
+void WordFrequency::siftUp(unsigned int position)
+{
+	while (position > 0) {
+
+		unsigned int parent = (position - 1) / 2;
+
+		if (slots[heap[parent]].count <= slots[heap[position]].count) {
+
+			return;
+		}
+
+		std::swap(heap[position], heap[parent]);
+		slots[heap[position]].heapPos = position;
+		slots[heap[parent]].heapPos = parent;
+		position = parent;
+	}
+}
@@ -0,0 +1,156 @@
+/**
+ * @file word_frequency.h - Declaration of the streaming word frequency
+ * counter.
+ *
+ * @brief - Three counters share one hash of each word. Keys registered
+ * with track() are counted exactly in a HashMap. Every word goes into a
+ * Count-Min sketch whose estimates never undercount and overcount by at
+ * most epsilon * total with probability 1 - delta. A SpaceSaving summary
+ * of k slots follows the heaviest hitters of an unbounded stream in fixed
+ * memory.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __WORD_FREQUENCY_H
+#define __WORD_FREQUENCY_H
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include "hash_map.h"
+#include "string_arena.h"
+
+using std::string;
+using std::string_view;
+using std::vector;
+
+/**
+ * One entry of the top-k summary. The true frequency of word lies in
+ * [count - error, count].
+ */
+struct HeavyHitter {
+
+	string word;
+	uint64_t count;                  // upper bound on the frequency
+	uint64_t error;                  // overestimation inherited on entry
+};
+
+class WordFrequency {
+
+public:
+	WordFrequency(double epsilon = 0.0001, double delta = 0.001,
+		size_t topK = 100);
+	void add(string_view word);              // count one occurrence
+	bool processFile(string filename);       // add every word of a file
+	void track(string_view word);            // count word exactly from now on
+
+	uint64_t count(string_view word) const;     // exact if tracked, else estimate
+	uint64_t estimate(string_view word) const;  // Count-Min, never too low
+	bool exact(string_view word, uint64_t& count) const;  // tracked words only
+	vector<HeavyHitter> topK() const;        // heaviest first
+
+	uint64_t total() const;                  // words added
+	size_t width() const;                    // counters per sketch row
+	size_t depth() const;                    // sketch rows
+	size_t memoryUsage() const;
+
+private:
+	struct WordQuery {
+
+		string_view word;
+		uint64_t hash;
+	};
+
+	// exact counts, keys live in the arena like the Hash table's
+	struct TrackedHash {
+		size_t operator()(const KeyRecord& key) const { return key.hash; }
+		size_t operator()(const WordQuery& key) const
+		{
+			return (unsigned int)key.hash;
+		}
+	};
+
+	struct TrackedEqual {
+		const StringArena *arena;
+		bool operator()(const KeyRecord& stored, const WordQuery& key) const
+		{
+			return stored.hash == (unsigned int)key.hash
+				&& stored.length == key.word.size()
+				&& memcmp(arena->view(stored).data(), key.word.data(),
+					key.word.size()) == 0;
+		}
+		bool operator()(const KeyRecord& stored, const KeyRecord& key) const
+		{
+			return stored.offset == key.offset
+				&& stored.length == key.length;
+		}
+	};
+
+	// SpaceSaving slots are indexed by slot number, the characters live
+	// in the slot itself so an evicted word gives its space to the next
+	struct Slot {
+
+		string word;
+		uint64_t hash;
+		uint64_t count;
+		uint64_t error;
+		unsigned int heapPos;    // position in the min-heap of counts
+	};
+
+	struct SlotHash {
+		const vector<Slot> *slots;
+		size_t operator()(unsigned int slot) const
+		{
+			return (*slots)[slot].hash;
+		}
+		size_t operator()(const WordQuery& key) const { return key.hash; }
+	};
+
+	struct SlotEqual {
+		const vector<Slot> *slots;
+		bool operator()(unsigned int stored, const WordQuery& key) const
+		{
+			const Slot& slot = (*slots)[stored];
+
+			return slot.hash == key.hash && slot.word == key.word;
+		}
+		bool operator()(unsigned int stored, unsigned int key) const
+		{
+			return stored == key;
+		}
+	};
+
+	vector<uint32_t> sketch;         // depth rows of width counters
+	size_t rowMask;                  // width - 1, width is a power of two
+	size_t rows;
+	uint64_t words;
+
+	StringArena arena;
+	HashMap<KeyRecord, uint64_t, TrackedHash, TrackedEqual> tracked;
+
+	size_t capacity;                 // k
+	vector<Slot> slots;
+	vector<unsigned int> heap;       // slot numbers, smallest count on top
+	HashMap<unsigned int, char, SlotHash, SlotEqual> slotIndex;
+
+	WordQuery query(string_view word) const;
+	void addToSketch(uint64_t hash);
+	uint64_t sketchMinimum(uint64_t hash) const;
+	void addToSummary(const WordQuery& key);
+	void siftDown(unsigned int position);
+	void siftUp(unsigned int position);
+
+	size_t counterOf(uint64_t hash, size_t row) const
+	{
+		uint32_t step = (uint32_t)(hash >> 32) | 1;
+
+		return row * (rowMask + 1) + (((uint32_t)hash + row * step) & rowMask);
+	}
+};
+
+#endif
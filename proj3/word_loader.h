@@ -0,0 +1,124 @@
+/**
+ * @file word_loader.h - Whitespace tokenizer for word files held in memory.
+ *
+ * @brief - Splits a buffer into words the same way operator>> does for a
+ * string, but sixteen bytes at a time: a SSE2 compare builds a bit mask
+ * of the whitespace in each block and only the word boundaries in that
+ * mask are visited. Words are handed out as string_views into the buffer,
+ * nothing is copied or allocated.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __WORD_LOADER_H
+#define __WORD_LOADER_H
+
+#include <string_view>
+#include <cstddef>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using std::string_view;
+
+/**
+ * Same characters isspace accepts in the "C" locale
+ */
+inline bool isWordSpace(char c)
+{
+	return c == ' ' || (unsigned char)(c - '\t') <= '\r' - '\t';
+}
+
+
+/**
+ * Bit i of the result is set when block[i] is whitespace
+ *
+ * @param block - Sixteen readable bytes
+ */
+inline unsigned int whitespaceMask(const char *block)
+{
+#ifdef __SSE2__
+	__m128i chars = _mm_loadu_si128((const __m128i *)block);
+	__m128i space = _mm_cmpeq_epi8(chars, _mm_set1_epi8(' '));
+	__m128i control = _mm_sub_epi8(chars, _mm_set1_epi8('\t'));
+	__m128i range = _mm_set1_epi8('\r' - '\t');
+
+	control = _mm_cmpeq_epi8(_mm_min_epu8(control, range), control);
+
+	return (unsigned int)_mm_movemask_epi8(_mm_or_si128(space, control));
+#else
+	unsigned int mask = 0;
+
+	for (int i = 0; i < 16; i++) {
+
+		mask |= (unsigned int)isWordSpace(block[i]) << i;
+	}
+
+	return mask;
+#endif
+}
+
+
+/**
+ * Calls visit once for every whitespace separated word of data, in order
+ *
+ * @param data - Buffer to tokenize
+ * @param size - Length of data
+ * @param visit - Callable taking a string_view
+ */
+template <class Visit>
+void forEachWord(const char *data, size_t size, Visit visit)
+{
+	size_t start = 0;
+	bool inWord = false;
+	size_t i = 0;
+
+	for (; i + 16 <= size; i += 16) {
+
+		unsigned int word = ~whitespaceMask(data + i) & 0xFFFF;
+		unsigned int previous = (word << 1 | (inWord ? 1 : 0)) & 0xFFFF;
+		unsigned int edges = word ^ previous;
+
+		while (edges != 0) {
+
+			size_t at = i + __builtin_ctz(edges);
+			edges &= edges - 1;
+
+			if (inWord) {
+
+				visit(string_view(data + start, at - start));
+			}
+			else {
+
+				start = at;
+			}
+
+			inWord = !inWord;
+		}
+	}
+
+	for (; i < size; i++) {
+
+		bool space = isWordSpace(data[i]);
+
+		if (inWord && space) {
+
+			visit(string_view(data + start, i - start));
+			inWord = false;
+		}
+		else if (!inWord && !space) {
+
+			start = i;
+			inWord = true;
+		}
+	}
+
+	if (inWord) {
+
+		visit(string_view(data + start, size - start));
+	}
+}
+
+#endif
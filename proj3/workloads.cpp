@@ -0,0 +1,870 @@
+/**
+ * @file workloads.cpp - Workload benchmark suite for the hash table
+ * variants.
+ *
+ * @brief - Runs a mix of inserts, lookups and removals against every
+ * table variant and reports throughput, the latency distribution, the
+ * resident memory per key and a histogram of probe lengths. Keys come
+ * from a word file or are generated, so the same workloads run from a
+ * thousand keys up to a hundred million.
+ *
+ *    load     insert every key into an empty table
+ *    read     95% lookups, 5% inserts of new keys
+ *    write    75% inserts of new keys, 25% lookups
+ *    churn    45% removals of the oldest key, 45% inserts, 10% lookups
+ *    lookup   lookups only
+ *
+ * Every table but load starts from the full key set. The keys present at
+ * any time are a sliding window of key numbers: inserts add at the top,
+ * churn removes at the bottom. A lookup hits the window with the --hit
+ * probability, otherwise it asks for a key that was never inserted, and
+ * with --zipf the hits are skewed towards the first keys of the window.
+ *
+ *    ./hashsuite [--keys N,N,...] [--corpus file] [--workload name|all]
+ *                [--table name|all] [--ops N] [--hit ratio] [--zipf s]
+ *
+ * Each (workload, table) pair runs in a child process so the resident
+ * memory it reports is its own. Probes are chain records compared for
+ * the chained tables, buckets read for the cuckoo table and chain nodes
+ * for std::unordered_map. The chained and filtered tables have a static
+ * 2^20 buckets, the growing table starts small and doubles. The static
+ * and saved tables are read-only: StaticHash, or the chained table in
+ * HashFile format, is built over the preloaded keys, saved and mapped
+ * back, so they only run the lookup workload. The filtered table also
+ * reports the false positive rate its filter showed, and the suite
+ * fails if that rate is above the 1% target by more than sampling error
+ * while the filter held no more keys than it was sized for.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "hash.h"
+#include "cuckoo_hash.h"
+#include "hash_mix.h"
+#include "static_hash.h"
+#include "hash_file.h"
+
+using std::cout;
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+static const uint64_t MISS_BASE = 1ULL << 48;   // first never inserted key
+static const int PROBE_SAMPLES = 10000;
+
+
+/**
+ * Produces key number i, either a word of a corpus or a generated key.
+ * Numbers below the corpus size are its words, higher numbers append a
+ * suffix so any number of distinct keys can be produced.
+ */
+class KeySource {
+
+public:
+	KeySource(vector<string> words) : words(words)
+	{
+	}
+
+	/**
+	 * Key number i, written to buffer when it has to be built
+	 *
+	 * @param i - Key number
+	 * @param buffer - At least 64 bytes of scratch space
+	 */
+	string_view key(uint64_t i, char *buffer) const
+	{
+		if (words.empty()) {
+
+			// 13 base-32 digits of a bijective mix, distinct for every i
+			static const char DIGITS[] = "abcdefghijklmnopqrstuvwxyz012345";
+			uint64_t bits = mix64(i);
+
+			for (int d = 0; d < 13; d++) {
+
+				buffer[d] = DIGITS[bits & 31];
+				bits >>= 5;
+			}
+
+			return string_view(buffer, 13);
+		}
+
+		const string& word = words[i % words.size()];
+
+		if (i < words.size()) {
+
+			return word;
+		}
+
+		memcpy(buffer, word.data(), word.size());
+
+		size_t length = word.size();
+
+		buffer[length++] = '~';
+		length += snprintf(buffer + length, 24, "%llu",
+			(unsigned long long)(i / words.size()));
+
+		return string_view(buffer, length);
+	}
+
+private:
+	vector<string> words;
+};
+
+
+/**
+ * Zipf distributed ranks 1..n, by rejection inversion (Hormann and
+ * Derflinger), constant time per sample for any n
+ */
+class ZipfRanks {
+
+public:
+	ZipfRanks(uint64_t n, double exponent) : n(n), s(exponent)
+	{
+		integralX1 = integral(1.5) - 1.0;
+		integralN = integral(n + 0.5);
+		squeeze = 2.0 - integralInverse(integral(2.5) - density(2.0));
+	}
+
+	template <class Random>
+	uint64_t operator()(Random& random)
+	{
+		std::uniform_real_distribution<double> uniform(0.0, 1.0);
+
+		while (true) {
+
+			double u = integralN + uniform(random) * (integralX1 - integralN);
+			double x = integralInverse(u);
+			uint64_t k = (uint64_t)std::max(1.0, std::min((double)n, x + 0.5));
+
+			if (k - x <= squeeze || u >= integral(k + 0.5) - density(k)) {
+
+				return k;
+			}
+		}
+	}
+
+private:
+	uint64_t n;
+	double s;
+	double integralX1;
+	double integralN;
+	double squeeze;
+
+	double density(double x) const
+	{
+		return std::exp(-s * std::log(x));
+	}
+
+	double integral(double x) const
+	{
+		double logX = std::log(x);
+		double t = (1.0 - s) * logX;
+
+		return (std::fabs(t) > 1e-8 ? std::expm1(t) / t : 1.0 + t / 2) * logX;
+	}
+
+	double integralInverse(double x) const
+	{
+		double t = std::max(-1.0, x * (1.0 - s));
+
+		return std::exp((std::fabs(t) > 1e-8 ? std::log1p(t) / t : 1.0 - t / 2)
+			* x);
+	}
+};
+
+
+/**
+ * Latency histogram with eight sub-buckets per power of two, so any
+ * number of operations fits in a fixed amount of memory and percentiles
+ * are exact to within 12.5%
+ */
+class LatencyHistogram {
+
+public:
+	LatencyHistogram() : counts(16 + 60 * 8, 0), total(0), longest(0)
+	{
+	}
+
+	void add(uint64_t nanoseconds)
+	{
+		counts[index(nanoseconds)]++;
+		total++;
+		longest = std::max(longest, nanoseconds);
+	}
+
+	uint64_t percentile(double fraction) const
+	{
+		uint64_t wanted = (uint64_t)std::ceil(fraction * total);
+		uint64_t seen = 0;
+
+		for (size_t i = 0; i < counts.size(); i++) {
+
+			seen += counts[i];
+
+			if (seen >= wanted && seen > 0) {
+
+				return lowest(i);
+			}
+		}
+
+		return longest;
+	}
+
+	uint64_t maximum() const
+	{
+		return longest;
+	}
+
+private:
+	vector<uint64_t> counts;
+	uint64_t total;
+	uint64_t longest;
+
+	static size_t index(uint64_t value)
+	{
+		if (value < 16) {
+
+			return value;
+		}
+
+		int exponent = 63 - __builtin_clzll(value);
+
+		return 16 + (exponent - 4) * 8 + ((value >> (exponent - 3)) & 7);
+	}
+
+	static uint64_t lowest(size_t index)
+	{
+		if (index < 16) {
+
+			return index;
+		}
+
+		int exponent = (int)(index - 16) / 8 + 4;
+
+		return (8 + (index - 16) % 8) << (exponent - 3);
+	}
+};
+
+
+/**
+ * The operations a workload needs, implemented by every table variant
+ */
+class Table {
+
+public:
+	virtual ~Table()
+	{
+	}
+
+	virtual void insert(string_view word) = 0;
+	virtual bool search(string_view word) = 0;
+	virtual void remove(string_view word) = 0;
+	virtual unsigned int probes(string_view word) = 0;
+
+	// called once the preload is done, before the timed operations
+	virtual void seal()
+	{
+	}
+
+	// the filter in front of the table, if it has one
+	virtual const MembershipFilter *filter()
+	{
+		return nullptr;
+	}
+};
+
+
+template <class Chained>
+class ChainedTable : public Table {
+
+public:
+	ChainedTable(size_t expected, bool filtered)
+	{
+		if (filtered) {
+
+			table.enableFilter(expected, 0.01);
+		}
+	}
+
+	void insert(string_view word) { table.insert(word); }
+	bool search(string_view word) { return table.search(word); }
+	void remove(string_view word) { table.remove(word); }
+	unsigned int probes(string_view word) { return table.probes(word); }
+	const MembershipFilter *filter() { return table.membershipFilter(); }
+
+private:
+	Chained table;
+};
+
+
+class CuckooTable : public Table {
+
+public:
+	CuckooTable(size_t expected) : table(expected)
+	{
+	}
+
+	void insert(string_view word) { table.insert(word); }
+	bool search(string_view word) { return table.search(word); }
+	void remove(string_view word) { table.remove(word); }
+	unsigned int probes(string_view word) { return table.probes(word); }
+
+private:
+	CuckooHash table;
+};
+
+
+/**
+ * StaticHash over the preloaded keys, searched through the mapping of
+ * its saved file. Inserts only collect keys until seal builds it.
+ */
+class StaticTable : public Table {
+
+public:
+	void insert(string_view word) { pending.emplace_back(word); }
+	bool search(string_view word) { return mapped.search(word); }
+	void remove(string_view) { }
+
+	// every key has exactly one candidate slot
+	unsigned int probes(string_view) { return mapped.size() > 0; }
+
+	void seal()
+	{
+		StaticHash built;
+		string filename = "hashsuite-" + std::to_string(getpid()) + ".phash";
+
+		if (!built.build(vector<string_view>(pending.begin(), pending.end()))
+			|| !built.save(filename) || !mapped.load(filename)) {
+
+			std::cerr << "hashsuite: cannot build " << filename << endl;
+			unlink(filename.c_str());
+			_exit(1);
+		}
+
+		unlink(filename.c_str());
+		pending.clear();
+	}
+
+private:
+	vector<string> pending;
+	StaticHash mapped;
+};
+
+
+/**
+ * The chained table saved in HashFile format and reopened, searched
+ * through the mapping. Its buckets are the chained table's own.
+ */
+class SavedTable : public Table {
+
+public:
+	void insert(string_view word) { table.insert(word); }
+	bool search(string_view word) { return file.search(word); }
+	void remove(string_view) { }
+	unsigned int probes(string_view word) { return table.probes(word); }
+
+	void seal()
+	{
+		string filename = "hashsuite-" + std::to_string(getpid()) + ".htbl";
+
+		if (!table.save(filename) || !file.open(filename)) {
+
+			std::cerr << "hashsuite: cannot reopen " << filename << endl;
+			unlink(filename.c_str());
+			_exit(1);
+		}
+
+		unlink(filename.c_str());
+	}
+
+private:
+	LargeHash table;
+	HashFile file;
+};
+
+
+class StandardTable : public Table {
+
+public:
+	StandardTable(size_t expected)
+	{
+		table.reserve(expected);
+	}
+
+	void insert(string_view word) { table[string(word)]++; }
+	bool search(string_view word) { return table.count(string(word)) > 0; }
+	void remove(string_view word) { table.erase(string(word)); }
+
+	unsigned int probes(string_view word)
+	{
+		string key(word);
+		size_t index = table.bucket(key);
+		unsigned int compared = 0;
+
+		for (auto it = table.begin(index); it != table.end(index); ++it) {
+
+			compared++;
+
+			if (it->first == key) {
+
+				break;
+			}
+		}
+
+		return compared;
+	}
+
+private:
+	std::unordered_map<string, unsigned int> table;
+};
+
+
+/**
+ * Operation mix of a workload, the fractions add up to one
+ */
+struct Workload {
+
+	string name;
+	bool preload;                    // start from the full key set
+	double insert;
+	double remove;
+	double search;
+};
+
+
+/**
+ * Settings shared by every run
+ */
+struct Options {
+
+	uint64_t ops;
+	double hit;                      // fraction of lookups that hit
+	double zipf;                     // 0 for uniform hits
+	uint64_t seed;
+};
+
+
+static Table *makeTable(const string& name, size_t expected)
+{
+	if (name == "chained") {
+
+		return new ChainedTable<LargeHash>(expected, false);
+	}
+
+	if (name == "filtered") {
+
+		return new ChainedTable<LargeHash>(expected, true);
+	}
+
+	if (name == "growing") {
+
+		return new ChainedTable<GrowingHash>(expected, false);
+	}
+
+	if (name == "cuckoo") {
+
+		return new CuckooTable(expected);
+	}
+
+	if (name == "static") {
+
+		return new StaticTable;
+	}
+
+	if (name == "saved") {
+
+		return new SavedTable;
+	}
+
+	return new StandardTable(expected);
+}
+
+
+/**
+ * Resident set size of this process in bytes
+ */
+static long residentBytes()
+{
+	long pages = 0;
+	long resident = 0;
+	std::ifstream statm("/proc/self/statm");
+
+	statm >> pages >> resident;
+
+	return resident * sysconf(_SC_PAGESIZE);
+}
+
+
+/**
+ * Prints the share of sampled lookups that needed 0, 1, ... 7 and 8 or
+ * more probes
+ *
+ * @param label - hit or miss
+ * @param lengths - Count of lookups per probe length
+ * @param samples - Number of lookups sampled
+ */
+static void printProbes(const char *label, const vector<int>& lengths,
+	int samples)
+{
+	cout << "      " << label << " probes";
+
+	for (size_t length = 0; length < lengths.size(); length++) {
+
+		if (lengths[length] > 0) {
+
+			cout << "  " << length << (length + 1 == lengths.size() ? "+" : "")
+				<< ":" << std::fixed << std::setprecision(1)
+				<< 100.0 * lengths[length] / samples << "%";
+		}
+	}
+
+	cout << endl;
+}
+
+
+/**
+ * Runs one workload against one table variant and prints its row and its
+ * probe histograms. Called in a child process.
+ *
+ * @param workload - Operation mix
+ * @param tableName - Variant to build
+ * @param keys - Key source
+ * @param size - Number of keys in the initial window
+ * @param options - Shared settings
+ */
+static void runWorkload(const Workload& workload, const string& tableName,
+	const KeySource& keys, uint64_t size, const Options& options)
+{
+	char buffer[64];
+	std::mt19937_64 random(options.seed);
+	std::uniform_real_distribution<double> uniform(0.0, 1.0);
+	ZipfRanks zipf(size, options.zipf > 0 ? options.zipf : 1.0);
+	LatencyHistogram latency;
+
+	long before = residentBytes();
+	Table *table = makeTable(tableName, size);
+	uint64_t low = 0;                // window of present keys [low, high)
+	uint64_t high = 0;
+	uint64_t ops = workload.preload ? options.ops : size;
+	uint64_t peak = 0;               // most keys present at once
+
+	if (workload.preload) {
+
+		for (; high < size; high++) {
+
+			table->insert(keys.key(high, buffer));
+		}
+	}
+
+	table->seal();
+
+	long loaded = residentBytes() - before;
+	uint64_t hits = 0;
+	Clock::time_point start = Clock::now();
+
+	for (uint64_t op = 0; op < ops; op++) {
+
+		double choice = uniform(random);
+		Clock::time_point begin;
+
+		if (choice < workload.insert) {
+
+			string_view word = keys.key(high++, buffer);
+
+			begin = Clock::now();
+			table->insert(word);
+		}
+		else if (choice < workload.insert + workload.remove && low < high) {
+
+			string_view word = keys.key(low++, buffer);
+
+			begin = Clock::now();
+			table->remove(word);
+		}
+		else {
+
+			string_view word;
+
+			if (low < high && uniform(random) < options.hit) {
+
+				uint64_t offset = options.zipf > 0 ? zipf(random) - 1
+					: random() % (high - low);
+
+				word = keys.key(low + offset % (high - low), buffer);
+			}
+			else {
+
+				word = keys.key(MISS_BASE + random() % MISS_BASE, buffer);
+			}
+
+			begin = Clock::now();
+			hits += table->search(word);
+		}
+
+		latency.add(std::chrono::duration_cast<std::chrono::nanoseconds>(
+			Clock::now() - begin).count());
+		peak = std::max(peak, high - low);
+	}
+
+	double seconds = std::chrono::duration<double>(Clock::now() - start)
+		.count();
+	long grown = std::max(loaded, residentBytes() - before);
+
+	const MembershipFilter *filter = table->filter();
+	double observed = filter ? filter->falsePositiveRate() : 0.0;
+	unsigned long absent = filter ? filter->rejected()
+		+ filter->falsePositives() : 0;
+	vector<int> hitLengths(9, 0);
+	vector<int> missLengths(9, 0);
+
+	for (int i = 0; i < PROBE_SAMPLES && low < high; i++) {
+
+		unsigned int length = table->probes(
+			keys.key(low + random() % (high - low), buffer));
+
+		hitLengths[std::min<size_t>(length, 8)]++;
+		length = table->probes(keys.key(MISS_BASE + random() % MISS_BASE,
+			buffer));
+		missLengths[std::min<size_t>(length, 8)]++;
+	}
+
+	cout << std::left << setw(7) << workload.name << setw(10) << tableName
+		<< std::right << setw(11) << size << std::fixed
+		<< std::setprecision(0) << setw(12) << ops / seconds
+		<< setw(8) << latency.percentile(0.5)
+		<< setw(8) << latency.percentile(0.9)
+		<< setw(8) << latency.percentile(0.99)
+		<< setw(9) << latency.percentile(0.999)
+		<< setw(10) << latency.maximum()
+		<< setw(9) << std::setprecision(1) << (double)grown / std::max<uint64_t>(high - low, 1)
+		<< setw(9) << hits << endl;
+
+	printProbes("hit ", hitLengths, PROBE_SAMPLES);
+	printProbes("miss", missLengths, PROBE_SAMPLES);
+
+	delete table;
+
+	if (absent == 0) {
+
+		return;
+	}
+
+	// three standard errors of the observed rate
+	double target = 0.01;
+	double slack = 3.0 * std::sqrt(target * (1.0 - target) / absent);
+	bool failed = peak <= size && observed > target + slack;
+
+	cout << "      filter false positives " << std::setprecision(4)
+		<< observed << " of " << absent << " absent (target " << target
+		<< (peak > size ? ", overfull)" : ")") << (failed ? "  FAILED" : "")
+		<< endl;
+
+	if (failed) {
+
+		cout.flush();
+		_exit(2);
+	}
+}
+
+
+/**
+ * Reads the distinct whitespace separated words of a file
+ *
+ * @param filename - Name of the word file
+ */
+static vector<string> readWords(string filename)
+{
+	std::ifstream in(filename);
+	vector<string> words;
+	string word;
+
+	while (in >> word) {
+
+		words.push_back(word);
+	}
+
+	std::sort(words.begin(), words.end());
+	words.erase(std::unique(words.begin(), words.end()), words.end());
+
+	return words;
+}
+
+
+/**
+ * Splits a comma separated list
+ *
+ * @param list - Text such as "1000,1e6"
+ */
+static vector<uint64_t> parseSizes(string list)
+{
+	vector<uint64_t> sizes;
+	size_t start = 0;
+
+	while (start <= list.size()) {
+
+		size_t comma = list.find(',', start);
+
+		if (comma == string::npos) {
+
+			comma = list.size();
+		}
+
+		sizes.push_back((uint64_t)std::stod(list.substr(start, comma - start)));
+		start = comma + 1;
+	}
+
+	return sizes;
+}
+
+
+/**
+ * main
+ *
+ * @brief
+ *    parses the options and runs every selected workload, table and key
+ *    set combination
+ */
+int main(int argc, char *argv[])
+{
+	vector<uint64_t> sizes = { 1000, 10000, 100000, 1000000 };
+	string corpus;
+	string workloadName = "all";
+	string tableName = "all";
+	Options options = { 200000, 0.9, 0.0, 7 };
+	int failures = 0;
+
+	for (int i = 1; i + 1 < argc; i += 2) {
+
+		string flag = argv[i];
+		string value = argv[i + 1];
+
+		if (flag == "--keys") {
+
+			sizes = parseSizes(value);
+		}
+		else if (flag == "--corpus") {
+
+			corpus = value;
+		}
+		else if (flag == "--workload") {
+
+			workloadName = value;
+		}
+		else if (flag == "--table") {
+
+			tableName = value;
+		}
+		else if (flag == "--ops") {
+
+			options.ops = (uint64_t)std::stod(value);
+		}
+		else if (flag == "--hit") {
+
+			options.hit = std::stod(value);
+		}
+		else if (flag == "--zipf") {
+
+			options.zipf = std::stod(value);
+		}
+		else {
+
+			std::cerr << "unknown option " << flag << endl;
+			return 1;
+		}
+	}
+
+	vector<Workload> workloads = {
+		{ "load", false, 1.0, 0.0, 0.0 },
+		{ "read", true, 0.05, 0.0, 0.95 },
+		{ "write", true, 0.75, 0.0, 0.25 },
+		{ "churn", true, 0.45, 0.45, 0.10 },
+		{ "lookup", true, 0.0, 0.0, 1.0 }
+	};
+	vector<string> tables = { "chained", "filtered", "growing", "cuckoo",
+		"static", "saved", "unordered" };
+	vector<string> words;
+
+	if (!corpus.empty()) {
+
+		words = readWords(corpus);
+		sizes = { words.size() };
+	}
+
+	KeySource keys(words);
+
+	cout << "workloads over " << (corpus.empty() ? "generated keys" : corpus)
+		<< ", " << options.ops << " ops, " << options.hit * 100
+		<< "% hits, zipf " << options.zipf << endl;
+	cout << std::left << setw(7) << "work" << setw(10) << "table"
+		<< std::right << setw(11) << "keys" << setw(12) << "ops/s"
+		<< setw(8) << "p50 ns" << setw(8) << "p90 ns" << setw(8) << "p99 ns"
+		<< setw(9) << "p999 ns" << setw(10) << "max ns" << setw(9) << "B/key"
+		<< setw(9) << "hits" << endl;
+
+	for (uint64_t size : sizes) {
+
+		for (const Workload& workload : workloads) {
+
+			if (workloadName != "all" && workloadName != workload.name) {
+
+				continue;
+			}
+
+			for (const string& table : tables) {
+
+				if (tableName != "all" && tableName != table) {
+
+					continue;
+				}
+
+				// a read-only table cannot run a workload that changes keys
+				bool changesKeys = !workload.preload
+					|| workload.insert + workload.remove > 0;
+
+				if ((table == "static" || table == "saved") && changesKeys) {
+
+					continue;
+				}
+
+				cout.flush();
+
+				pid_t child = fork();
+
+				if (child == 0) {
+
+					runWorkload(workload, table, keys, size, options);
+					cout.flush();
+					_exit(0);
+				}
+
+				int status = 0;
+
+				waitpid(child, &status, 0);
+
+				if (!WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+
+					failures++;
+				}
+			}
+		}
+	}
+
+	return failures > 0 ? 1 : 0;
+}
@@ -0,0 +1,877 @@
+/**
+ * @file bench.cpp - Throughput benchmark for the min-priority queue.
+ *
+ * @brief - Replays scheduling workloads against each heap layout: n jobs
+ * are queued with random deadlines, deadlines are pulled forward, and the
+ * queue is drained in priority order. The schedule workload moves every
+ * deadline once, extract moves none, so the drain dominates, and
+ * decrease moves every deadline eight times in random order, the shape
+ * of a shortest path or spanning tree run. The drain is checked to come
+ * out sorted, so a broken heap fails loudly instead of just looking
+ * fast. Where the kernel allows it the run also counts last-level cache
+ * misses with perf_event_open, which is what separates the pointer
+ * layout from the contiguous ones. The dijkstra workload runs shortest
+ * paths over a random graph with the 1..99 edge weights mstapp accepts,
+ * where decreaseKey and extractMin interleave and keys only grow, the
+ * case the pairing and radix heaps are built for; every engine has to
+ * produce the same distances. The concurrent workload has 1 to 8 threads
+ * share one job queue, each alternating insert and extractMin, and
+ * compares Minpriority behind a mutex with LockedHeap and MultiQueue,
+ * then measures how far MultiQueue's relaxed order strays. The build
+ * workload fills a queue with n inserts against one buildFrom, and
+ * merges two halves with meld against inserting one half into the
+ * other. The timer workload fires and re-arms timers a bounded number of
+ * ticks ahead, the case BucketQueue and TimerWheel are for; they also
+ * run the dijkstra workload, whose keys grow by at most 99 a step.
+ *
+ *    ./pqbench [jobs] [schedule|extract|decrease|dijkstra|timer|build|
+ *                      concurrent|all]
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include "minpriority.h"
+#include "concurrent_queue.h"
+
+using std::cout;
+using std::endl;
+using std::setw;
+using std::string;
+using std::vector;
+
+typedef std::chrono::steady_clock Clock;
+
+
+/**
+ * Hardware cache miss counter for the calling thread, reads -1 when the
+ * kernel or the sandbox does not expose one
+ */
+class CacheMisses {
+
+public:
+	CacheMisses()
+	{
+		perf_event_attr attr;
+
+		memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = PERF_COUNT_HW_CACHE_MISSES;
+		attr.disabled = 1;
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+
+		fd = syscall(__NR_perf_event_open, &attr, 0, -1, -1, 0);
+	}
+
+	~CacheMisses()
+	{
+		if (fd >= 0)
+		{
+			close(fd);
+		}
+	}
+
+	void start()
+	{
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+			ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+		}
+	}
+
+	long long stop()
+	{
+		long long count = -1;
+
+		if (fd >= 0)
+		{
+			ioctl(fd, PERF_EVENT_IOC_DISABLE, 0);
+
+			if (read(fd, &count, sizeof(count)) != sizeof(count))
+			{
+				count = -1;
+			}
+		}
+
+		return count;
+	}
+
+private:
+	int fd;
+};
+
+
+/**
+ * @brief
+ *    seconds elapsed since begin
+ *
+ * @param begin - start of the timed region
+ *
+ * @return elapsed seconds
+ */
+static double since(Clock::time_point begin)
+{
+	return std::chrono::duration<double>(Clock::now() - begin).count();
+}
+
+
+/**
+ * @brief
+ *    runs one workload on one queue configuration and prints a row of
+ *    phase times, throughput and cache misses
+ *
+ * @param layout - row label
+ * @param names - job ids
+ * @param deadlines - initial key of each job
+ * @param moves - job whose deadline is pulled forward, in order
+ */
+template <class Queue>
+static void timeWorkload(string layout, const vector<string>& names,
+	const vector<int>& deadlines, const vector<int>& moves)
+{
+	int jobs = names.size();
+	vector<int> keys = deadlines;
+	CacheMisses misses;
+	Queue queue;
+
+	misses.start();
+	Clock::time_point begin = Clock::now();
+
+	for (int i = 0; i < jobs; i++)
+	{
+		queue.insert(names[i], keys[i]);
+	}
+
+	double inserted = since(begin);
+	begin = Clock::now();
+
+	for (int job : moves)
+	{
+		keys[job] -= keys[job] / 4 + 1;
+		queue.decreaseKey(names[job], keys[job]);
+	}
+
+	double decreased = since(begin);
+	begin = Clock::now();
+
+	vector<string> order;
+
+	while (queue.size() > 0)
+	{
+		order.push_back(queue.extractMin());
+	}
+
+	double extracted = since(begin);
+	long long missed = misses.stop();
+
+	std::unordered_map<string, int> keyOf;
+	bool sorted = (int)order.size() == jobs;
+	int previous = INT_MIN;
+
+	for (int i = 0; i < jobs; i++)
+	{
+		keyOf[names[i]] = keys[i];
+	}
+
+	for (const string& name : order)
+	{
+		sorted = sorted && keyOf[name] >= previous;
+		previous = keyOf[name];
+	}
+
+	double total = inserted + decreased + extracted;
+
+	cout << std::left << setw(10) << layout << std::right << std::fixed
+		<< std::setprecision(3) << setw(9) << inserted << setw(9)
+		<< decreased << setw(9) << extracted << setw(9) << total
+		<< std::setprecision(0) << setw(12)
+		<< (2 * jobs + moves.size()) / total;
+
+	if (missed >= 0)
+	{
+		cout << setw(12) << missed / 1000;
+	}
+	else
+	{
+		cout << setw(12) << "n/a";
+	}
+
+	cout << (sorted ? "" : "  (NOT SORTED)") << endl;
+}
+
+
+/**
+ * @brief
+ *    times every heap layout on one workload
+ *
+ * @param workload - name printed above the table
+ * @param names - job ids
+ * @param deadlines - initial key of each job
+ * @param moves - job whose deadline is pulled forward, in order
+ */
+static void compareLayouts(string workload, const vector<string>& names,
+	const vector<int>& deadlines, const vector<int>& moves)
+{
+	cout << endl << workload << ": " << names.size() << " jobs, "
+		<< moves.size() << " decreaseKeys, seconds per phase" << endl;
+	cout << std::left << setw(10) << "layout" << std::right << setw(9)
+		<< "insert" << setw(9) << "decrease" << setw(9) << "extract"
+		<< setw(9) << "total" << setw(12) << "ops/s" << setw(12)
+		<< "kmisses" << endl;
+
+	timeWorkload<PointerMinpriority>("pointer", names, deadlines, moves);
+	timeWorkload<PackedMinpriority>("packed", names, deadlines, moves);
+	timeWorkload<SplitMinpriority>("split", names, deadlines, moves);
+	timeWorkload<Minpriority>("4-ary", names, deadlines, moves);
+	timeWorkload<OctalMinpriority>("8-ary", names, deadlines, moves);
+	timeWorkload<PairingMinpriority>("pairing", names, deadlines, moves);
+	timeWorkload<RadixMinpriority>("radix", names, deadlines, moves);
+}
+
+
+/**
+ * @brief
+ *    times bulk construction and merging on one queue configuration and
+ *    prints a row of seconds per method
+ *
+ * @param layout - row label
+ * @param entries - job ids and keys
+ */
+template <class Queue>
+static void timeBuild(string layout,
+	const vector<std::pair<string, int> >& entries)
+{
+	size_t half = entries.size() / 2;
+	vector<std::pair<string, int> > low(entries.begin(),
+		entries.begin() + half);
+	vector<std::pair<string, int> > high(entries.begin() + half,
+		entries.end());
+	Queue inserted, built, melded, other, grown;
+
+	Clock::time_point begin = Clock::now();
+
+	for (const std::pair<string, int>& entry : entries)
+	{
+		inserted.insert(entry.first, entry.second);
+	}
+
+	double insertTime = since(begin);
+	begin = Clock::now();
+
+	built.buildFrom(entries);
+
+	double buildTime = since(begin);
+
+	melded.buildFrom(low);
+	other.buildFrom(high);
+	begin = Clock::now();
+
+	melded.meld(other);
+
+	double meldTime = since(begin);
+
+	grown.buildFrom(low);
+	begin = Clock::now();
+
+	for (const std::pair<string, int>& entry : high)
+	{
+		grown.insert(entry.first, entry.second);
+	}
+
+	double insertsTime = since(begin);
+
+	std::unordered_map<string, int> keyOf(entries.begin(), entries.end());
+	bool sorted = melded.size() == (int)entries.size() && other.size() == 0;
+	int previous = INT_MIN;
+
+	while (sorted && built.size() > 0)
+	{
+		int key = keyOf[built.extractMin()];
+
+		sorted = key >= previous;
+		previous = key;
+	}
+
+	cout << std::left << setw(10) << layout << std::right << std::fixed
+		<< std::setprecision(3) << setw(10) << insertTime << setw(10)
+		<< buildTime << setw(10) << meldTime << setw(10) << insertsTime
+		<< (sorted ? "" : "  (NOT SORTED)") << endl;
+}
+
+
+/**
+ * @brief
+ *    times buildFrom and meld on every heap layout
+ *
+ * @param names - job ids
+ * @param keys - key of each job
+ */
+static void compareBuild(const vector<string>& names, const vector<int>& keys)
+{
+	vector<std::pair<string, int> > entries;
+
+	for (size_t i = 0; i < names.size(); i++)
+	{
+		entries.push_back(std::make_pair(names[i], keys[i]));
+	}
+
+	cout << endl << "build: " << names.size() << " jobs, seconds to fill one "
+		<< "queue and to merge two halves" << endl;
+	cout << std::left << setw(10) << "layout" << std::right << setw(10)
+		<< "insert" << setw(10) << "buildFrom" << setw(10) << "meld"
+		<< setw(10) << "inserts" << endl;
+
+	timeBuild<PointerMinpriority>("pointer", entries);
+	timeBuild<PackedMinpriority>("packed", entries);
+	timeBuild<SplitMinpriority>("split", entries);
+	timeBuild<Minpriority>("4-ary", entries);
+	timeBuild<OctalMinpriority>("8-ary", entries);
+	timeBuild<PairingMinpriority>("pairing", entries);
+	timeBuild<RadixMinpriority>("radix", entries);
+}
+
+
+/**
+ * Random directed graph, edges of vertex v at edges[first[v]] ...
+ */
+struct Graph {
+
+	vector<int> first;
+	vector<int> target;
+	vector<int> weight;
+};
+
+
+/**
+ * @brief
+ *    runs Dijkstra's algorithm from vertex 0 with one queue configuration
+ *    and prints its time, operation counts and a checksum of distances
+ *
+ * @param engine - row label
+ * @param graph - graph to search
+ * @param names - vertex ids
+ */
+template <class Queue>
+static void timeShortestPaths(string engine, const Graph& graph,
+	const vector<string>& names)
+{
+	int vertices = names.size();
+	vector<int> distance(vertices, INT_MAX);
+	vector<bool> settled(vertices, false);
+	std::unordered_map<string, int> vertexOf;
+	long long decreases = 0;
+	Queue queue;
+
+	for (int v = 0; v < vertices; v++)
+	{
+		vertexOf[names[v]] = v;
+	}
+
+	Clock::time_point begin = Clock::now();
+
+	distance[0] = 0;
+	queue.insert(names[0], 0);
+
+	while (queue.size() > 0)
+	{
+		int u = vertexOf[queue.extractMin()];
+
+		settled[u] = true;
+
+		for (int e = graph.first[u]; e < graph.first[u + 1]; e++)
+		{
+			int v = graph.target[e];
+			int through = distance[u] + graph.weight[e];
+
+			if (settled[v] || through >= distance[v])
+			{
+				continue;
+			}
+
+			if (distance[v] == INT_MAX)
+			{
+				queue.insert(names[v], through);
+			}
+			else
+			{
+				queue.decreaseKey(names[v], through);
+				decreases++;
+			}
+
+			distance[v] = through;
+		}
+	}
+
+	double elapsed = since(begin);
+	long long checksum = 0;
+
+	for (int d : distance)
+	{
+		checksum += d == INT_MAX ? 0 : d;
+	}
+
+	cout << std::left << setw(10) << engine << std::right << std::fixed
+		<< std::setprecision(3) << setw(9) << elapsed << setw(12)
+		<< decreases << setw(16) << checksum << endl;
+}
+
+
+
+/**
+ * @brief
+ *    times every engine running shortest paths over one random graph
+ *
+ * @param names - vertex ids
+ * @param random - generator for the edges
+ */
+static void compareShortestPaths(const vector<string>& names,
+	std::mt19937& random)
+{
+	int vertices = names.size();
+	int degree = 8;
+	std::uniform_int_distribution<int> vertex(0, vertices - 1);
+	std::uniform_int_distribution<int> weight(1, 99);
+	Graph graph;
+
+	for (int v = 0; v < vertices; v++)
+	{
+		graph.first.push_back(graph.target.size());
+
+		for (int e = 0; e < degree; e++)
+		{
+			graph.target.push_back(vertex(random));
+			graph.weight.push_back(weight(random));
+		}
+	}
+
+	graph.first.push_back(graph.target.size());
+
+	cout << endl << "dijkstra: " << vertices << " vertices, "
+		<< graph.target.size() << " edges, weights 1..99" << endl;
+	cout << std::left << setw(10) << "engine" << std::right << setw(9)
+		<< "seconds" << setw(12) << "decreases" << setw(16) << "checksum"
+		<< endl;
+
+	timeShortestPaths<PackedMinpriority>("binary", graph, names);
+	timeShortestPaths<Minpriority>("4-ary", graph, names);
+	timeShortestPaths<PairingMinpriority>("pairing", graph, names);
+	timeShortestPaths<RadixMinpriority>("radix", graph, names);
+	timeShortestPaths<BucketMinpriority>("bucket", graph, names);
+	timeShortestPaths<WheelMinpriority>("wheel", graph, names);
+}
+
+
+/**
+ * @brief
+ *    runs a timer loop on one queue configuration: the earliest timer
+ *    fires, is re-armed 1..100 ticks later, and every fourth firing pulls
+ *    another timer's deadline halfway in. Prints time, throughput and
+ *    whether timers fired in deadline order.
+ *
+ * @param engine - row label
+ * @param names - timer ids
+ * @param firings - timers fired in total
+ */
+template <class Queue>
+static void timeTimers(string engine, const vector<string>& names,
+	int firings)
+{
+	int timers = names.size();
+	vector<int> due(timers);
+	std::unordered_map<string, int> timerOf;
+	std::mt19937 random(7);
+	std::uniform_int_distribution<int> delay(1, 100);
+	std::uniform_int_distribution<int> timer(0, timers - 1);
+	long long operations = 0;
+	Queue queue;
+
+	for (int t = 0; t < timers; t++)
+	{
+		timerOf[names[t]] = t;
+		due[t] = delay(random);
+		queue.insert(names[t], due[t]);
+	}
+
+	Clock::time_point begin = Clock::now();
+	bool inOrder = true;
+	int now = 0;
+
+	for (int fired = 0; fired < firings; fired++)
+	{
+		int t = timerOf[queue.extractMin()];
+
+		inOrder = inOrder && due[t] >= now;
+		now = due[t];
+		operations++;
+
+		if (fired % 4 == 0)
+		{
+			int other = timer(random);
+
+			if (other != t && due[other] > now + 1)
+			{
+				due[other] = now + 1 + (due[other] - now - 1) / 2;
+				queue.decreaseKey(names[other], due[other]);
+				operations++;
+			}
+		}
+
+		due[t] = now + delay(random);
+		queue.insert(names[t], due[t]);
+		operations++;
+	}
+
+	double elapsed = since(begin);
+
+	cout << std::left << setw(10) << engine << std::right << std::fixed
+		<< std::setprecision(3) << setw(9) << elapsed << std::setprecision(0)
+		<< setw(12) << operations / elapsed
+		<< (inOrder ? "" : "  (OUT OF ORDER)") << endl;
+}
+
+
+/**
+ * @brief
+ *    times the timer loop on the heaps and on the bucket engines
+ *
+ * @param names - timer ids
+ */
+static void compareTimers(const vector<string>& names)
+{
+	int firings = 4 * names.size();
+
+	cout << endl << "timer: " << names.size() << " timers, " << firings
+		<< " firings, deadlines 1..100 ticks ahead" << endl;
+	cout << std::left << setw(10) << "engine" << std::right << setw(9)
+		<< "seconds" << setw(12) << "ops/s" << endl;
+
+	timeTimers<PackedMinpriority>("binary", names, firings);
+	timeTimers<Minpriority>("4-ary", names, firings);
+	timeTimers<RadixMinpriority>("radix", names, firings);
+	timeTimers<BucketMinpriority>("bucket", names, firings);
+	timeTimers<WheelMinpriority>("wheel", names, firings);
+}
+
+
+/**
+ * Minpriority behind a single mutex, the baseline for the concurrent
+ * queues
+ */
+class GuardedMinpriority {
+
+public:
+	void insert(const string& name, int key_val)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		queue.insert(name, key_val);
+	}
+
+	bool extractMin(string& name, int& key_val)
+	{
+		std::lock_guard<std::mutex> guard(lock);
+
+		if (queue.size() == 0)
+		{
+			return false;
+		}
+
+		name = queue.extractMin();
+		key_val = 0;
+
+		return true;
+	}
+
+private:
+	std::mutex lock;
+	Minpriority queue;
+};
+
+
+/**
+ * @brief
+ *    has every thread alternate insert and extractMin on a shared queue
+ *
+ * @param queue - prefilled queue under test
+ * @param threads - number of threads
+ * @param ops - operations per thread
+ *
+ * @return operations per second over all threads
+ */
+template <class Queue>
+static double timeShared(Queue& queue, int threads, int ops)
+{
+	vector<vector<string> > names(threads);
+
+	for (int t = 0; t < threads; t++)
+	{
+		for (int i = 0; i < ops / 2; i++)
+		{
+			names[t].push_back("t" + std::to_string(t) + "-" + std::to_string(i));
+		}
+	}
+
+	std::atomic<bool> go(false);
+	vector<std::thread> workers;
+
+	for (int t = 0; t < threads; t++)
+	{
+		workers.emplace_back([&queue, &names, &go, t]() {
+
+			std::minstd_rand random(t + 1);
+			string name;
+			int key;
+
+			while (!go.load())
+			{
+				std::this_thread::yield();
+			}
+
+			for (const string& job : names[t])
+			{
+				queue.insert(job, random() % 1000000);
+				queue.extractMin(name, key);
+			}
+		});
+	}
+
+	Clock::time_point begin = Clock::now();
+
+	go.store(true);
+
+	for (std::thread& worker : workers)
+	{
+		worker.join();
+	}
+
+	return threads * (ops / 2) * 2 / since(begin);
+}
+
+
+/**
+ * @brief
+ *    rank error of MultiQueue: threads insert the keys 0 .. n-1 at once,
+ *    then one thread drains the queue and, for every key it gets, counts
+ *    the smaller keys still queued
+ *
+ * @param threads - number of producer threads
+ * @param n - number of keys
+ * @param worst - receives the largest rank error
+ *
+ * @return mean rank error
+ */
+static double rankError(int threads, int n, long& worst)
+{
+	MultiQueue queue(threads);
+	vector<int> keys(n);
+	vector<std::thread> producers;
+
+	for (int i = 0; i < n; i++)
+	{
+		keys[i] = i;
+	}
+
+	std::shuffle(keys.begin(), keys.end(), std::mt19937(threads));
+
+	for (int t = 0; t < threads; t++)
+	{
+		producers.emplace_back([&queue, &keys, threads, n, t]() {
+
+			for (int i = t; i < n; i += threads)
+			{
+				queue.insert("", keys[i]);
+			}
+		});
+	}
+
+	for (std::thread& producer : producers)
+	{
+		producer.join();
+	}
+
+	// Fenwick tree over the keys still queued
+	vector<int> tree(n + 1, 0);
+
+	for (int i = 1; i <= n; i++)
+	{
+		for (int j = i; j <= n; j += j & -j)
+		{
+			tree[j]++;
+		}
+	}
+
+	string name;
+	int key;
+	double total = 0;
+
+	worst = 0;
+
+	while (queue.extractMin(name, key))
+	{
+		long smaller = 0;
+
+		for (int j = key; j > 0; j -= j & -j)
+		{
+			smaller += tree[j];
+		}
+
+		for (int j = key + 1; j <= n; j += j & -j)
+		{
+			tree[j]--;
+		}
+
+		total += smaller;
+		worst = std::max(worst, smaller);
+	}
+
+	return total / n;
+}
+
+
+/**
+ * @brief
+ *    scalability of the shared queues from 1 to 8 threads
+ *
+ * @param ops - operations per thread
+ */
+static void compareConcurrent(int ops)
+{
+	int prefill = 100000;
+
+	cout << endl << "concurrent: " << ops << " ops per thread, insert and "
+		<< "extractMin alternating, " << prefill << " jobs prefilled, "
+		<< std::thread::hardware_concurrency() << " hardware threads" << endl;
+	cout << std::left << setw(8) << "threads" << std::right << setw(14)
+		<< "mutex ops/s" << setw(14) << "locked ops/s" << setw(14)
+		<< "multiq ops/s" << setw(12) << "rank mean" << setw(10) << "rank max"
+		<< endl;
+
+	for (int threads = 1; threads <= 8; threads *= 2)
+	{
+		GuardedMinpriority guarded;
+		LockedHeap locked(prefill + threads);
+		MultiQueue relaxed(threads);
+
+		for (int i = 0; i < prefill; i++)
+		{
+			string job = "pre" + std::to_string(i);
+			int key = (i * 7919) % 1000000;
+
+			guarded.insert(job, key);
+			locked.insert(job, key);
+			relaxed.insert(job, key);
+		}
+
+		double mutexRate = timeShared(guarded, threads, ops);
+		double lockedRate = timeShared(locked, threads, ops);
+		double relaxedRate = timeShared(relaxed, threads, ops);
+		long worst;
+		double mean = rankError(threads, prefill, worst);
+
+		cout << std::left << setw(8) << threads << std::right << std::fixed
+			<< std::setprecision(0) << setw(14) << mutexRate << setw(14)
+			<< lockedRate << setw(14) << relaxedRate << std::setprecision(1)
+			<< setw(12) << mean << setw(10) << worst << endl;
+	}
+}
+
+
+/**
+ * main
+ *
+ * @brief
+ *    times insert, decreaseKey and extractMin over a scheduling workload
+ *    for every heap layout
+ */
+int main(int argc, char *argv[])
+{
+	int jobs = argc > 1 ? atoi(argv[1]) : 1000000;
+
+	std::mt19937 random(42);
+	std::uniform_int_distribution<int> deadline(0, 1 << 30);
+
+	vector<string> names;
+	vector<int> keys;
+
+	for (int i = 0; i < jobs; i++)
+	{
+		names.push_back("job" + std::to_string(i));
+		keys.push_back(deadline(random));
+	}
+
+	string workload = argc > 2 ? argv[2] : "all";
+	vector<int> moves;
+
+	if (workload == "schedule" || workload == "all")
+	{
+		for (int i = 0; i < jobs; i++)
+		{
+			moves.push_back(i);
+		}
+
+		compareLayouts("schedule", names, keys, moves);
+	}
+
+	if (workload == "extract" || workload == "all")
+	{
+		moves.clear();
+		compareLayouts("extract", names, keys, moves);
+	}
+
+	if (workload == "decrease" || workload == "all")
+	{
+		moves.clear();
+
+		for (int round = 0; round < 8; round++)
+		{
+			for (int i = 0; i < jobs; i++)
+			{
+				moves.push_back(i);
+			}
+		}
+
+		std::shuffle(moves.begin(), moves.end(), random);
+		compareLayouts("decrease", names, keys, moves);
+	}
+
+	if (workload == "dijkstra" || workload == "all")
+	{
+		compareShortestPaths(names, random);
+	}
+
+	if (workload == "timer" || workload == "all")
+	{
+		compareTimers(names);
+	}
+
+	if (workload == "build" || workload == "all")
+	{
+		compareBuild(names, keys);
+	}
+
+	if (workload == "concurrent" || workload == "all")
+	{
+		compareConcurrent(std::min(jobs, 200000));
+	}
+
+	return 0;
+}
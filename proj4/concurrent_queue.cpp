@@ -0,0 +1,440 @@
+/**
+ * @file concurrent_queue.cpp - MultiQueue and the fine-grained locking
+ * heap.
+ *
+ * @brief - The two queues trade order for throughput differently:
+ * MultiQueue never waits on a lock it can avoid, LockedHeap waits only
+ * for the nodes on its own sift path.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <random>
+#include <thread>
+#include "concurrent_queue.h"
+
+/**
+ * Small id of the calling thread, handed out on first use
+ */
+static int threadIndex()
+{
+	static std::atomic<int> threads(0);
+	thread_local int index = threads++;
+
+	return index;
+}
+
+
+/**
+ * Per-thread generator, so sampling never shares state between threads
+ */
+static std::minstd_rand& threadRandom()
+{
+	thread_local std::minstd_rand random(0x9e3779b9u * (threadIndex() + 1));
+
+	return random;
+}
+
+
+/**
+ * Spins on the flag, yielding so an oversubscribed core lets the holder
+ * finish
+ */
+void SpinLock::lock()
+{
+	while (flag.test_and_set(std::memory_order_acquire))
+	{
+		std::this_thread::yield();
+	}
+}
+
+
+/**
+ * Builds the shards for a number of threads
+ *
+ * @param threads - Threads expected to share the queue
+ * @param perThread - Heaps per thread, more lowers contention and
+ * raises the rank error
+ */
+MultiQueue::MultiQueue(unsigned int threads, unsigned int perThread)
+	: count(std::max(2u, threads * perThread)), queued(0)
+{
+	shards.reset(new Shard[count]);
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		shards[i].top.store(INT_MAX, std::memory_order_relaxed);
+	}
+}
+
+
+/**
+ * The heap the calling thread inserts into
+ */
+MultiQueue::Shard& MultiQueue::home()
+{
+	return shards[threadIndex() % count];
+}
+
+
+/**
+ * A uniformly random heap
+ */
+unsigned int MultiQueue::pick()
+{
+	return threadRandom()() % count;
+}
+
+
+/**
+ * Queues name on the calling thread's home heap, or on a random one when
+ * another thread holds it
+ *
+ * @param name - Job id
+ * @param key_val - Priority, smaller comes out first
+ */
+void MultiQueue::insert(const string& name, int key_val)
+{
+	Shard *shard = &home();
+
+	while (!shard->lock.try_lock())
+	{
+		shard = &shards[pick()];
+	}
+
+	shard->heap.push_back(Job{key_val, name});
+	std::push_heap(shard->heap.begin(), shard->heap.end(),
+		[](const Job& a, const Job& b) { return a.key > b.key; });
+	shard->top.store(shard->heap.front().key, std::memory_order_release);
+	shard->lock.unlock();
+
+	queued.fetch_add(1, std::memory_order_relaxed);
+}
+
+
+/**
+ * Pops the minimum of one heap, the caller holds its lock
+ *
+ * @return false if the heap turned out to be empty
+ */
+bool MultiQueue::popFrom(Shard& shard, string& name, int& key_val)
+{
+	if (shard.heap.empty())
+	{
+		shard.lock.unlock();
+		return false;
+	}
+
+	std::pop_heap(shard.heap.begin(), shard.heap.end(),
+		[](const Job& a, const Job& b) { return a.key > b.key; });
+
+	name.swap(shard.heap.back().id);
+	key_val = shard.heap.back().key;
+	shard.heap.pop_back();
+
+	shard.top.store(shard.heap.empty() ? INT_MAX : shard.heap.front().key,
+		std::memory_order_release);
+	shard.lock.unlock();
+
+	queued.fetch_sub(1, std::memory_order_relaxed);
+
+	return true;
+}
+
+
+/**
+ * Removes a job with a small key: of two random heaps, the one whose
+ * minimum is smaller. Falls back to a sweep over every heap before
+ * reporting the queue empty, so a job is never left behind.
+ *
+ * @param name - Receives the job id
+ * @param key_val - Receives its priority
+ *
+ * @return false if every heap was empty
+ */
+bool MultiQueue::extractMin(string& name, int& key_val)
+{
+	for (int attempt = 0; attempt < 4; attempt++)
+	{
+		Shard& first = shards[pick()];
+		Shard& second = shards[pick()];
+		Shard& smaller = second.top.load(std::memory_order_acquire)
+			< first.top.load(std::memory_order_acquire) ? second : first;
+
+		if (smaller.top.load(std::memory_order_acquire) == INT_MAX
+			&& queued.load(std::memory_order_relaxed) <= 0)
+		{
+			return false;
+		}
+
+		if (smaller.lock.try_lock() && popFrom(smaller, name, key_val))
+		{
+			return true;
+		}
+	}
+
+	for (unsigned int i = 0; i < count; i++)
+	{
+		shards[i].lock.lock();
+
+		if (popFrom(shards[i], name, key_val))
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+/**
+ * Jobs queued, exact once producers and workers are quiet
+ */
+size_t MultiQueue::size() const
+{
+	long jobs = queued.load(std::memory_order_relaxed);
+
+	return jobs > 0 ? jobs : 0;
+}
+
+
+/**
+ * Allocates every node up front, the heap never moves. One spare node
+ * past the end gives every parent a right child to lock and compare.
+ *
+ * @param capacity - Most jobs queued at once
+ */
+LockedHeap::LockedHeap(size_t capacity)
+	: nodes(new Node[capacity + 2]), capacity(capacity), next(ROOT)
+{
+	for (size_t i = 0; i < capacity + 2; i++)
+	{
+		nodes[i].tag = EMPTY;
+		nodes[i].owner = -1;
+	}
+}
+
+
+/**
+ * Swaps the contents of two locked nodes
+ */
+void LockedHeap::exchange(size_t i, size_t j)
+{
+	std::swap(nodes[i].tag, nodes[j].tag);
+	std::swap(nodes[i].owner, nodes[j].owner);
+	std::swap(nodes[i].key, nodes[j].key);
+	nodes[i].id.swap(nodes[j].id);
+}
+
+
+/**
+ * True when node i is still being sifted up by the calling thread
+ */
+bool LockedHeap::owned(size_t i) const
+{
+	return nodes[i].tag == BUSY && nodes[i].owner == threadIndex();
+}
+
+
+/**
+ * Places name in the next free slot marked BUSY and sifts it up, locking
+ * a parent and child at a time. A removal may move the node meanwhile;
+ * ownership tells the thread to follow it upward.
+ *
+ * @param name - Job id
+ * @param key_val - Priority, smaller comes out first
+ *
+ * @return false if the heap is full
+ */
+bool LockedHeap::insert(const string& name, int key_val)
+{
+	heapLock.lock();
+
+	if (next > capacity)
+	{
+		heapLock.unlock();
+		return false;
+	}
+
+	size_t child = next++;
+
+	nodes[child].lock.lock();
+	heapLock.unlock();
+
+	nodes[child].tag = BUSY;
+	nodes[child].owner = threadIndex();
+	nodes[child].key = key_val;
+	nodes[child].id = name;
+	nodes[child].lock.unlock();
+
+	while (child > ROOT)
+	{
+		size_t parent = child / 2;
+		size_t old = child;
+
+		nodes[parent].lock.lock();
+		nodes[child].lock.lock();
+
+		if (nodes[parent].tag == AVAILABLE && owned(child))
+		{
+			if (nodes[child].key < nodes[parent].key)
+			{
+				exchange(child, parent);
+				child = parent;
+			}
+			else
+			{
+				nodes[child].tag = AVAILABLE;
+				nodes[child].owner = -1;
+				nodes[old].lock.unlock();
+				nodes[parent].lock.unlock();
+				return true;
+			}
+		}
+		else if (!owned(child))
+		{
+			child = parent;
+		}
+
+		nodes[old].lock.unlock();
+		nodes[parent].lock.unlock();
+
+		// parent still busy with another insert, let its owner run
+		if (child == old)
+		{
+			std::this_thread::yield();
+		}
+	}
+
+	if (child == ROOT)
+	{
+		nodes[ROOT].lock.lock();
+
+		if (owned(ROOT))
+		{
+			nodes[ROOT].tag = AVAILABLE;
+			nodes[ROOT].owner = -1;
+		}
+
+		nodes[ROOT].lock.unlock();
+	}
+
+	return true;
+}
+
+
+/**
+ * Takes the root, moves the last node up in its place and sifts it down
+ * holding the parent and the two children it compares
+ *
+ * @param name - Receives the job id
+ * @param key_val - Receives its priority
+ *
+ * @return false if the heap is empty
+ */
+bool LockedHeap::extractMin(string& name, int& key_val)
+{
+	heapLock.lock();
+
+	if (next == ROOT)
+	{
+		heapLock.unlock();
+		return false;
+	}
+
+	size_t bottom = --next;
+
+	nodes[ROOT].lock.lock();
+
+	if (bottom != ROOT)
+	{
+		nodes[bottom].lock.lock();
+	}
+
+	heapLock.unlock();
+
+	name.swap(nodes[ROOT].id);
+	key_val = nodes[ROOT].key;
+	nodes[ROOT].tag = EMPTY;
+	nodes[ROOT].owner = -1;
+
+	if (bottom == ROOT)
+	{
+		nodes[ROOT].lock.unlock();
+		return true;
+	}
+
+	exchange(bottom, ROOT);
+	nodes[bottom].lock.unlock();
+
+	if (nodes[ROOT].tag == EMPTY)
+	{
+		nodes[ROOT].lock.unlock();
+		return true;
+	}
+
+	// a node still being inserted is now ordered by this sift instead
+	nodes[ROOT].tag = AVAILABLE;
+	nodes[ROOT].owner = -1;
+
+	size_t parent = ROOT;
+
+	while (2 * parent <= capacity)
+	{
+		size_t left = 2 * parent;
+		size_t right = left + 1;
+		size_t child;
+
+		nodes[left].lock.lock();
+		nodes[right].lock.lock();
+
+		if (nodes[left].tag == EMPTY)
+		{
+			nodes[right].lock.unlock();
+			nodes[left].lock.unlock();
+			break;
+		}
+		else if (nodes[right].tag == EMPTY
+			|| nodes[left].key < nodes[right].key)
+		{
+			nodes[right].lock.unlock();
+			child = left;
+		}
+		else
+		{
+			nodes[left].lock.unlock();
+			child = right;
+		}
+
+		if (nodes[child].key < nodes[parent].key)
+		{
+			exchange(parent, child);
+			nodes[parent].lock.unlock();
+			parent = child;
+		}
+		else
+		{
+			nodes[child].lock.unlock();
+			break;
+		}
+	}
+
+	nodes[parent].lock.unlock();
+
+	return true;
+}
+
+
+/**
+ * Jobs queued, including ones still being sifted into place
+ */
+size_t LockedHeap::size()
+{
+	std::lock_guard<std::mutex> guard(heapLock);
+
+	return next - ROOT;
+}
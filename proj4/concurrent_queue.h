@@ -0,0 +1,132 @@
+/**
+ * @file concurrent_queue.h - Priority queues shared by producer and
+ * worker threads.
+ *
+ * @brief - Minpriority is single threaded. MultiQueue relaxes the order to
+ * scale: it keeps a few small heaps per thread, each behind its own lock,
+ * a thread inserts into its home heap, and extractMin compares the minima
+ * of two randomly chosen heaps and pops the smaller one. The element
+ * returned is not always the global minimum, but its expected rank is
+ * bounded by the number of heaps, and threads rarely touch the same lock.
+ * LockedHeap keeps the strict order with the fine-grained locking heap of
+ * Hunt et al.: one lock per node, held only around the two nodes a sift
+ * step compares, so operations on different paths proceed in parallel.
+ * A short global lock only hands out the next free or last used slot.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __CONCURRENT_QUEUE_H
+#define __CONCURRENT_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+using std::string;
+
+/**
+ * Test-and-set lock small enough to sit in every heap node
+ */
+class SpinLock {
+
+public:
+	SpinLock()
+	{
+		flag.clear();
+	}
+
+	void lock();
+
+	bool try_lock()
+	{
+		return !flag.test_and_set(std::memory_order_acquire);
+	}
+
+	void unlock()
+	{
+		flag.clear(std::memory_order_release);
+	}
+
+private:
+	std::atomic_flag flag;
+};
+
+
+class MultiQueue {
+
+public:
+	MultiQueue(unsigned int threads, unsigned int perThread = 2);
+
+	MultiQueue(const MultiQueue&) = delete;
+	MultiQueue& operator=(const MultiQueue&) = delete;
+
+	void insert(const string& name, int key_val);
+	bool extractMin(string& name, int& key_val);   // false when empty
+	size_t size() const;
+
+private:
+	struct Job {
+
+		int key;
+		string id;
+	};
+
+	// each heap on cache lines of its own, so locks never share a line
+	struct alignas(64) Shard {
+
+		SpinLock lock;
+		std::atomic<int> top;        // smallest key, INT_MAX when empty
+		std::vector<Job> heap;
+	};
+
+	std::unique_ptr<Shard[]> shards;
+	unsigned int count;
+	std::atomic<long> queued;
+
+	Shard& home();
+	unsigned int pick();
+	bool popFrom(Shard& shard, string& name, int& key_val);
+};
+
+
+class LockedHeap {
+
+public:
+	explicit LockedHeap(size_t capacity);
+
+	LockedHeap(const LockedHeap&) = delete;
+	LockedHeap& operator=(const LockedHeap&) = delete;
+
+	bool insert(const string& name, int key_val);  // false when full
+	bool extractMin(string& name, int& key_val);   // false when empty
+	size_t size();
+
+private:
+	enum Tag { EMPTY, AVAILABLE, BUSY };
+
+	struct Node {
+
+		SpinLock lock;
+		Tag tag;
+		int owner;       // thread still sifting a BUSY node up
+		int key;
+		string id;
+	};
+
+	static const size_t ROOT = 1;
+
+	std::mutex heapLock;             // guards next
+	std::unique_ptr<Node[]> nodes;   // 1-indexed, nodes[0] unused
+	size_t capacity;
+	size_t next;
+
+	void exchange(size_t i, size_t j);
+	bool owned(size_t i) const;
+};
+
+#endif
@@ -1,6 +1,12 @@
 /*
  *@brief main.cpp - Min-Priority Queue main/process input functions
  *
+ * Commands are read from stdin line by line, or with a file argument the
+ * whole file is mapped and replayed: the lines are tokenized in place,
+ * consecutive inserts go to the heap as one run, and extracted names are
+ * collected in one large output buffer. The command s prints the queue's
+ * operation counters, see pq_stats.h.
+ *
  * @author Alex Moxon
  *
  * @date: April 1st 2019
@@ -11,8 +17,12 @@
 #include <vector>
 #include <sstream>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <charconv>
 #include <string>
 #include "minpriority.h"
+#include "mapped_file.h"
 
 using std::stringstream;
 using std::string;
@@ -32,7 +42,8 @@ using std::endl;
  *    for mainLoop to determine if the quit command
  *    has been passed
  */
-bool Minpriority::processCommand(string& data)
+template <class Engine>
+bool BasicMinpriority<Engine>::processCommand(string& data)
 {
 	string name, cmd;
 	int key_val;
@@ -60,7 +71,11 @@ bool Minpriority::processCommand(string& data)
 	}
 	else if (cmd == "x")
 	{
-		extractMin();
+		cout << extractMin() << endl;
+	}
+	else if (cmd == "s")
+	{
+		stats().dump(cout);
 	}
 	else if (cmd == "q")
 	{
@@ -74,7 +89,8 @@ bool Minpriority::processCommand(string& data)
 /**
  * The Min priority queue main loop will process command lines until finished.
  */
-void Minpriority::mainLoop()
+template <class Engine>
+void BasicMinpriority<Engine>::mainLoop()
 {
 	string data ="";
 	while(processCommand(data) && cin.peek() != EOF)
@@ -83,6 +99,248 @@ void Minpriority::mainLoop()
 	}
 }
 
+template void Minpriority::mainLoop();
+
+/**
+ * Splits command text into lines and blank separated tokens without
+ * copying it
+ */
+class CommandScanner {
+
+public:
+	CommandScanner(const char *text, size_t length)
+		: next(text), cursor(text), lineEnd(text), end(text + length)
+	{
+
+	}
+
+	/**
+	 * @brief
+	 *    moves to the next line
+	 *
+	 * @return false once the text is used up
+	 */
+	bool nextLine()
+	{
+		if (next >= end)
+		{
+			return false;
+		}
+
+		cursor = next;
+		lineEnd = (const char *)memchr(next, '\n', end - next);
+
+		if (lineEnd == nullptr)
+		{
+			lineEnd = end;
+		}
+
+		next = lineEnd + 1;
+		return true;
+	}
+
+	/**
+	 * @brief
+	 *    next token of the current line
+	 *
+	 * @param start - receives the first character of the token
+	 * @param length - receives its length
+	 * @return false at the end of the line
+	 */
+	bool token(const char *&start, size_t& length)
+	{
+		while (cursor < lineEnd && blank(*cursor))
+		{
+			cursor++;
+		}
+
+		start = cursor;
+
+		while (cursor < lineEnd && !blank(*cursor))
+		{
+			cursor++;
+		}
+
+		length = cursor - start;
+		return length > 0;
+	}
+
+	/**
+	 * @brief
+	 *    next token of the current line read as an int
+	 *
+	 * @param value - receives the number
+	 * @return false if the token is missing or not a number
+	 */
+	bool number(int& value)
+	{
+		const char *start;
+		size_t length;
+
+		if (!token(start, length))
+		{
+			return false;
+		}
+
+		std::from_chars_result parsed =
+			std::from_chars(start, start + length, value);
+
+		return parsed.ec == std::errc() && parsed.ptr == start + length;
+	}
+
+private:
+	const char *next;      // first character of the following line
+	const char *cursor;    // scan position in the current line
+	const char *lineEnd;   // newline or end of text closing the line
+	const char *end;
+
+	static bool blank(char c)
+	{
+		return c == ' ' || c == '\t' || c == '\r';
+	}
+};
+
+/**
+ * Output lines gathered in one large buffer, written with a single call
+ * whenever it fills and when the writer goes away
+ */
+class OutputBuffer {
+
+public:
+	explicit OutputBuffer(FILE *out) : out(out), buffer(1 << 20), used(0)
+	{
+
+	}
+
+	~OutputBuffer()
+	{
+		flush();
+	}
+
+	void line(const string& text)
+	{
+		if (used + text.size() + 1 > buffer.size())
+		{
+			flush();
+		}
+
+		if (text.size() + 1 > buffer.size())
+		{
+			fwrite(text.data(), 1, text.size(), out);
+			fputc('\n', out);
+			return;
+		}
+
+		memcpy(&buffer[used], text.data(), text.size());
+		used += text.size();
+		buffer[used++] = '\n';
+	}
+
+	void flush()
+	{
+		fwrite(buffer.data(), 1, used, out);
+		fflush(out);
+		used = 0;
+	}
+
+private:
+	FILE *out;
+	std::vector<char> buffer;
+	size_t used;
+};
+
+/**
+ * replay
+ *
+ * @brief
+ *    runs a command log held in memory, the same commands as mainLoop.
+ *    A run of consecutive inserts is handed to the engine at once, which
+ *    heapifies it in O(n) instead of sifting every entry; the run ends at
+ *    the first other command, so extractions see the same queue.
+ *
+ * @param commands - the command text, one command per line
+ * @param length - bytes of command text
+ */
+template <class Engine>
+void BasicMinpriority<Engine>::replay(const char *commands, size_t length)
+{
+	CommandScanner scan(commands, length);
+	OutputBuffer out(stdout);
+	EntryRun run;
+	string name;
+	const char *word;
+	size_t size;
+	int key_val;
+
+	// a batched run is counted as one build
+	auto pushRun = [&]()
+	{
+		PQ_SCOPE(counters, PQ_BUILD);
+
+		engine.pushAll(run);
+		run.clear();
+	};
+
+	while (scan.nextLine())
+	{
+		if (!scan.token(word, size))
+		{
+			continue;
+		}
+
+		char cmd = size == 1 ? word[0] : '\0';
+
+		if (cmd == 'a')
+		{
+			if (scan.token(word, size) && scan.number(key_val))
+			{
+				name.assign(word, size);
+				run.push_back(std::make_pair(intern(name), key_val));
+			}
+
+			continue;
+		}
+
+		if (!run.empty())
+		{
+			pushRun();
+		}
+
+		if (cmd == 'd')
+		{
+			if (scan.token(word, size) && scan.number(key_val))
+			{
+				name.assign(word, size);
+				decreaseKey(name, key_val);
+			}
+		}
+		else if (cmd == 'x')
+		{
+			out.line(extractMin());
+		}
+		else if (cmd == 's')
+		{
+			std::ostringstream text;
+
+			stats().dump(text);
+			string table = text.str();
+			table.pop_back();
+			out.line(table);
+		}
+		else if (cmd == 'q')
+		{
+			return;
+		}
+	}
+
+	if (!run.empty())
+	{
+		pushRun();
+	}
+}
+
+template void Minpriority::replay(const char *commands, size_t length);
+
 /**
  * main
  *
@@ -90,13 +348,28 @@ void Minpriority::mainLoop()
  *    main loop
  *    initializes our minHeap and calls its mainLoop()
  *
- * @param none
+ * @param argv[1] - optional command file to replay instead of stdin
  *
- * @return 0
+ * @return 0, or 1 if the command file cannot be read
  */
-int main() {
+int main(int argc, char *argv[]) {
 
   Minpriority minHeap;
+
+  if (argc > 1)
+  {
+    MappedFile commands;
+
+    if (!commands.open(argv[1]))
+    {
+      std::cerr << "minq: cannot read " << argv[1] << endl;
+      return 1;
+    }
+
+    minHeap.replay(commands.data(), commands.size());
+    return 0;
+  }
+
   minHeap.mainLoop();
 
   return 0;
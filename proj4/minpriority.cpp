@@ -11,154 +11,199 @@
 #include <vector>
 #include "minpriority.h"
 
-using std::swap;
-
 /**
  * @brief
- *    initialize our heap to 0
+ *    initialize an empty queue
  *
  * @param none
  *
  * @return none
  */
-Minpriority::Minpriority()
+template <class Engine>
+BasicMinpriority<Engine>::BasicMinpriority()
 {
-	heap_size = 0;
+
 }
 
 /**
  * @brief
- *    Heap constructor
+ *    Heap destructor, the engine frees its own storage
  *
  * @param none
  *
  * @return none
  */
-Minpriority::~Minpriority()
+template <class Engine>
+BasicMinpriority<Engine>::~BasicMinpriority()
 {
 
 }
 
 /**
  * @brief
- *    returns the parent of the given key
- *
- * @param int i - key for where to put our data in the min-heap.
+ *    inserts name into min-heap with the given key_value. A name that is
+ *    already queued keeps its single entry and only its key may decrease.
  *
- * @return - parent key
+ * @param string name - name to be inserted into the min-heap
+ * @param int key_val - value on min-heap where the name will be inserted at
+ * @return
  */
-int Minpriority::parent(int i)
+template <class Engine>
+void BasicMinpriority<Engine>::insert(const string& name, int key_val)
 {
-	return((i + 1) / 2) - 1;
+	PQ_SCOPE(counters, PQ_INSERT);
+
+	unsigned int handle = intern(name);
+
+	if (engine.contains(handle))
+	{
+		engine.decrease(handle, key_val);
+	}
+	else
+	{
+		engine.push(handle, key_val);
+	}
 }
 
 /**
  * @brief
- *    returns the left value of the given key
- *
- * @param int i - key for where to put our data in the min-heap.
+ *    handle of name, a released one or else the next unused one when the
+ *    name is not queued.
  *
- * @return - key to the left
+ * @param string name - id to look up
+ * @return - the handle the engine stores for name
  */
-int Minpriority::left(int i)
+template <class Engine>
+unsigned int BasicMinpriority<Engine>::intern(const string& name)
 {
-	return(2 * (i + 1)) - 1;
+	std::unordered_map<string, unsigned int>::iterator found =
+		handles.find(name);
+
+	// find first, emplace would allocate a node even for a known name
+	if (found != handles.end())
+	{
+		return found->second;
+	}
+
+	unsigned int handle;
+
+	if (freeHandles.empty())
+	{
+		handle = names.size();
+		names.push_back(name);
+	}
+	else
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+		names[handle] = name;
+	}
+
+	handles.emplace(name, handle);
+
+	return handle;
 }
 
 /**
  * @brief
- *    returns the right value of the given key
- *
- * @param int i - key for where to put our data in the min-heap.
+ *    forgets the name of a handle that left the engine and keeps the
+ *    handle for the next new name
  *
- * @return key to the right
+ * @param handle - handle no longer queued
+ * @return - the name it stood for, moved out
  */
-int Minpriority::right(int i)
+template <class Engine>
+string BasicMinpriority<Engine>::release(unsigned int handle)
 {
-	return(2 * (i + 1));
+	handles.erase(names[handle]);
+	freeHandles.push_back(handle);
+
+	return std::move(names[handle]);
 }
 
 /**
  * @brief
- *    rebuilds the min-heap once data is implemented or taken away.
- *
- * @param 
+ *    lowers the key of name and moves it up the min-heap. The engine
+ *    knows the slot of every handle, so this costs O(log n).
  *
+ * @param string name - name whose key is lowered
+ * @param int key_val - new key, ignored unless smaller than the current one
  * @return
  */
-void Minpriority::buildMinHeap()
+template <class Engine>
+void BasicMinpriority<Engine>::decreaseKey(const string& name, int key_val)
 {
-	for (int i = (minHeap.size() / 2); i >= 0; i--)
+	PQ_SCOPE(counters, PQ_DECREASE);
+
+	std::unordered_map<string, unsigned int>::iterator found =
+		handles.find(name);
+
+	if (found != handles.end() && engine.contains(found->second))
 	{
-		minHeapify(i);
+		engine.decrease(found->second, key_val);
 	}
 }
 
 /**
  * @brief
- *    inserts name into min-heap with the given key_value.
+ *    adds a bulk input, such as a restored checkpoint, in one pass. A run
+ *    at least as long as the queue is heapified bottom-up, O(n), instead
+ *    of one O(log n) insert per entry. Repeated names keep the smallest
+ *    key, as with insert.
  *
- * @param string name - name to be inserted into the min-heap
- * @param int key_val - value on min-heap where the name will be inserted at
+ * @param entries - (name, key) pairs in any order
  * @return
  */
-void Minpriority::insert(string name, int key_val)
+template <class Engine>
+void BasicMinpriority<Engine>::buildFrom(
+	const std::vector<std::pair<string, int> >& entries)
 {
-	Element *ele = new Element;
+	PQ_SCOPE(counters, PQ_BUILD);
 
-	ele->key = key_val;
-	ele->id = name;
-	heap_size++;
+	EntryRun run;
 
-	minHeap.push_back(ele);
-	decreaseKey(name, key_val);
+	run.reserve(entries.size());
+
+	for (size_t i = 0; i < entries.size(); i++)
+	{
+		run.push_back(std::make_pair(intern(entries[i].first),
+			entries[i].second));
+	}
+
+	engine.pushAll(run);
 }
 
 /**
  * @brief
- *    removes name in min-heap with the given key_value.
+ *    moves every entry of other into this queue and leaves other empty.
+ *    The entries are taken out unsorted, O(m), and rebuilt here in
+ *    O(n + m), or pushed one by one when other is the smaller queue. A
+ *    name queued in both keeps the smaller key.
  *
- * @param string name - name to be removed from the min-heap
- * @param int key_val - value on min-heap where the name will be removed at
+ * @param other - queue to drain, e.g. a worker shard's partition
  * @return
  */
-void Minpriority::decreaseKey(string name, int key_val)
+template <class Engine>
+void BasicMinpriority<Engine>::meld(BasicMinpriority& other)
 {
-	int pos = 0;
-	Element *ele = nullptr;
+	PQ_SCOPE(counters, PQ_BUILD);
 
-	if (!minHeap.empty())
+	if (&other == this)
 	{
-		for (unsigned int i = 0; i <= minHeap.size() - 1; i++)
-		{
-			if (minHeap[i]->id == name)
-			{
-				pos = i;
-
-				if (key_val < minHeap[i]->key)
-				{
-					ele = minHeap[i];
-					minHeap[pos]->key = key_val;
-
-					while (pos > 0 && minHeap[parent(pos)]->key
-					 > minHeap[pos]->key)
-					{
-						swap(minHeap[parent(pos)], minHeap[pos]);
-						pos = parent(pos);
-					}
-				}
-				else
-				{
-					return;
-				}
-			}
-		}
+		return;
 	}
-	if (ele != nullptr)
+
+	EntryRun run;
+
+	run.reserve(other.engine.size());
+	other.engine.takeAll(run);
+
+	for (size_t r = 0; r < run.size(); r++)
 	{
-		ele->key = key_val;
-		buildMinHeap();
+		run[r].first = intern(other.release(run[r].first));
 	}
+
+	engine.pushAll(run);
 }
 
 /**
@@ -167,27 +212,19 @@ void Minpriority::decreaseKey(string name, int key_val)
  *
  * @param
  * 
- * @return - extracts and prints the minimum priority element.
+ * @return - the name with the minimum key, or "empty"
  */
-string Minpriority::extractMin()
+template <class Engine>
+string BasicMinpriority<Engine>::extractMin()
 {
+	PQ_SCOPE(counters, PQ_EXTRACT);
 
-	if (heap_size == 0)
+	if (engine.size() == 0)
 	{
 		return "empty";
 	}
 
-	Element *ele = minHeap[0];
-	string name = minHeap[0]->id;
-
-	minHeap[0] = minHeap[heap_size - 1];
-	minHeap.pop_back();
-
-	buildMinHeap();
-	heap_size--;
-
-	delete ele;
-	return name;
+	return release(engine.pop());
 }
 
 /**
@@ -198,53 +235,57 @@ string Minpriority::extractMin()
  * 
  * @return - true if name is part of heap
  */
-bool Minpriority::isMember(string name)
+template <class Engine>
+bool BasicMinpriority<Engine>::isMember(const string& name)
 {
+	PQ_SCOPE(counters, PQ_MEMBER);
 
-	for (std::vector<Element*>::iterator iter = minHeap.begin(); 
-		iter != minHeap.end(); iter++)
-	{
-		if (name == (*iter)->id)
-		{
-			return true;
-		}
-	}
+	std::unordered_map<string, unsigned int>::iterator found =
+		handles.find(name);
 
-	return false;
+	return found != handles.end() && engine.contains(found->second);
 }
 
 /**
  * @brief
- *    re-sorts the min-heap after an element has been added
+ *    number of elements in the min-heap
  *
- * @param int i - number of elements in the heap
- * 
- * @return
+ * @param
+ *
+ * @return - heap size
  */
-void Minpriority::minHeapify(int i)
+template <class Engine>
+int BasicMinpriority<Engine>::size()
 {
-	int l = left(i);
-	int r = right(i);
-	int min;
-
-	if (l <= heap_size && minHeap[l]->key < minHeap[i]->key)
-	{
-		min = l;
-	}
+	return (int)engine.size();
+}
 
-	else
-	{
-		min = i;
-	}
+/**
+ * @brief
+ *    snapshot of the operation counters, see pq_stats.h
+ *
+ * @param
+ *
+ * @return - counts per operation, all zero without -DPQ_STATS
+ */
+template <class Engine>
+PQStats BasicMinpriority<Engine>::stats() const
+{
+#ifdef PQ_STATS
+	return counters;
+#else
+	return PQStats();
+#endif
+}
 
-	if (r <= heap_size && minHeap[r]->key < minHeap[min]->key)
-	{
-		min = r;
-	}
 
-	if (min != i)
-	{
-		swap(minHeap[i], minHeap[min]);
-		minHeapify(min);
-	}
-}
\ No newline at end of file
+// the configurations minpriority.h names, main.cpp instantiates the driver
+template class BasicMinpriority<ArrayHeap<PackedSlots> >;
+template class BasicMinpriority<ArrayHeap<SplitSlots> >;
+template class BasicMinpriority<PointerHeap>;
+template class BasicMinpriority<DaryHeap<4> >;
+template class BasicMinpriority<DaryHeap<8> >;
+template class BasicMinpriority<PairingHeap>;
+template class BasicMinpriority<RadixHeap>;
+template class BasicMinpriority<BucketQueue<128> >;
+template class BasicMinpriority<TimerWheel>;
\ No newline at end of file
@@ -1,6 +1,20 @@
 /*
  * @brief minpriority.h Declaration of Min-Priority Queue
  *
+ * The queue interns every id as a small integer handle, once per distinct
+ * id, and keeps the heap itself in an engine from priority_engine.h that
+ * is chosen at compile time. Only insert, decreaseKey and isMember hash
+ * the id; extractMin and every sift work on handles. A handle is only
+ * held while its id is queued: extraction releases it onto a free list
+ * for the next new id, so the map and every per-handle array stay as
+ * large as the most ids ever queued at once.
+ * Minpriority is the default configuration; the other typedefs keep the
+ * alternative layouts available for benchmarks. replay runs a whole
+ * command log held in memory, see main.cpp. buildFrom and meld hand whole
+ * runs of entries to the engine, which heapifies them in linear time.
+ * Built with -DPQ_STATS every operation is counted and timed, stats()
+ * returns the counts and the driver's "s" command prints them.
+ *
  * @author Alex Moxon
  *
  * @date: March 30th 2019
@@ -13,38 +27,53 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <unordered_map>
+#include <utility>
+#include "priority_engine.h"
 
 using std::string;
 
-class Minpriority {
+template <class Engine>
+class BasicMinpriority {
 
 public:
-	Minpriority();
-	~Minpriority();
-	void insert(string name, int key_val);
-	void decreaseKey(string name, int key_val);
+	BasicMinpriority();
+	~BasicMinpriority();
+	void insert(const string& name, int key_val);
+	void decreaseKey(const string& name, int key_val);
+	void buildFrom(const std::vector<std::pair<string, int> >& entries);
+	void meld(BasicMinpriority& other);
 	void mainLoop();
-	bool isMember(string name);
+	void replay(const char *commands, size_t length);
+	bool isMember(const string& name);
+	string extractMin();
+	int size();
+	PQStats stats() const;   // all zero unless built with -DPQ_STATS
 
 private:
-	class Element {
-
-	public:
-		string id;
-		int key;
-	};
+	Engine engine;
+	std::unordered_map<string, unsigned int> handles;   // id -> handle
+	std::vector<string> names;                          // handle -> id
+	std::vector<unsigned int> freeHandles;              // released handles
+#ifdef PQ_STATS
+	PQStats counters;
+#endif
 
-	std::vector<Element*> minHeap;
-
-	void buildMinHeap();
+	unsigned int intern(const string& name);
+	string release(unsigned int handle);
 	bool processCommand(string& data);
-	void minHeapify(int i);
-	int parent(int i);
-	int left(int i);
-	int right(int i);
-	int heap_size;
-	string extractMin();
 
 };
 
+// heaps instantiated in minpriority.cpp
+typedef BasicMinpriority<DaryHeap<4> > Minpriority;
+typedef BasicMinpriority<DaryHeap<8> > OctalMinpriority;
+typedef BasicMinpriority<ArrayHeap<PackedSlots> > PackedMinpriority;
+typedef BasicMinpriority<ArrayHeap<SplitSlots> > SplitMinpriority;
+typedef BasicMinpriority<PointerHeap> PointerMinpriority;
+typedef BasicMinpriority<PairingHeap> PairingMinpriority;
+typedef BasicMinpriority<RadixHeap> RadixMinpriority;
+typedef BasicMinpriority<BucketQueue<128> > BucketMinpriority;
+typedef BasicMinpriority<TimerWheel> WheelMinpriority;
+
 #endif
\ No newline at end of file
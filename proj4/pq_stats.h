@@ -0,0 +1,188 @@
+/**
+ * @file pq_stats.h - Optional operation counters for the priority queues.
+ *
+ * @brief - Built with -DPQ_STATS, every public queue operation opens a
+ * PQScope that names and times it, and the heap code below it counts key
+ * comparisons, element moves, sifts and the levels they cross, linear
+ * scan steps and whole-heap rebuilds into the stats of the queue being
+ * operated on. Latencies go into a power-of-two histogram per operation.
+ * Without the flag PQ_SCOPE and PQ_COUNT expand to nothing and queues
+ * carry no counters, so the default build pays nothing. A queue's
+ * stats() returns a snapshot and dump prints it as a table.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __PQ_STATS_H
+#define __PQ_STATS_H
+
+#include <chrono>
+#include <cstring>
+#include <iomanip>
+#include <ostream>
+
+enum PQOp { PQ_INSERT, PQ_DECREASE, PQ_EXTRACT, PQ_BUILD, PQ_MEMBER, PQ_OPS };
+
+static const int PQ_LATENCY_BUCKETS = 32;   // bucket b: [2^b, 2^(b+1)) ns
+
+/**
+ * Counters of one operation type
+ */
+struct PQOpStats {
+
+	unsigned long long calls;
+	unsigned long long comparisons;   // key against key
+	unsigned long long swaps;         // elements moved by a sift
+	unsigned long long sifts;
+	unsigned long long siftLevels;    // levels crossed by all sifts
+	unsigned long long scans;         // buckets or entries stepped over
+	unsigned long long heapBuilds;    // bottom-up heapify or rebucket
+	unsigned long long latency[PQ_LATENCY_BUCKETS];
+
+	// nanoseconds within which the given fraction of calls finished,
+	// rounded up to the histogram bucket
+	unsigned long long percentile(double fraction) const
+	{
+		unsigned long long seen = 0;
+
+		for (int b = 0; b < PQ_LATENCY_BUCKETS; b++)
+		{
+			seen += latency[b];
+
+			if (seen > 0 && seen >= fraction * calls)
+			{
+				return 2ULL << b;
+			}
+		}
+
+		return 0;
+	}
+};
+
+
+/**
+ * Snapshot of every operation type of one queue
+ */
+class PQStats {
+
+public:
+	PQOpStats op[PQ_OPS];
+
+	PQStats()
+	{
+		reset();
+	}
+
+	void reset()
+	{
+		memset(op, 0, sizeof(op));
+	}
+
+	void dump(std::ostream& out) const
+	{
+#ifdef PQ_STATS
+		static const char *names[PQ_OPS] =
+			{ "insert", "decrease", "extract", "build", "member" };
+
+		out << std::left << std::setw(9) << "op" << std::right
+			<< std::setw(10) << "calls" << std::setw(12) << "compares"
+			<< std::setw(11) << "swaps" << std::setw(7) << "depth"
+			<< std::setw(10) << "scans" << std::setw(7) << "builds"
+			<< std::setw(9) << "p50 ns" << std::setw(9) << "p99 ns"
+			<< std::endl;
+
+		for (int o = 0; o < PQ_OPS; o++)
+		{
+			const PQOpStats& s = op[o];
+
+			out << std::left << std::setw(9) << names[o] << std::right
+				<< std::setw(10) << s.calls << std::setw(12)
+				<< s.comparisons << std::setw(11) << s.swaps
+				<< std::setw(7) << std::fixed << std::setprecision(1)
+				<< (s.sifts ? (double)s.siftLevels / s.sifts : 0.0)
+				<< std::setw(10) << s.scans << std::setw(7) << s.heapBuilds
+				<< std::setw(9) << s.percentile(0.5) << std::setw(9)
+				<< s.percentile(0.99) << std::endl;
+		}
+#else
+		out << "stats not built in, rebuild with -DPQ_STATS" << std::endl;
+#endif
+	}
+};
+
+#ifdef PQ_STATS
+
+/**
+ * The queue and operation the calling thread is inside of
+ */
+struct PQContext {
+
+	PQStats *stats;
+	PQOp op;
+};
+
+
+inline PQContext& pqContext()
+{
+	static thread_local PQContext context = { nullptr, PQ_INSERT };
+
+	return context;
+}
+
+
+inline void pqCount(unsigned long long PQOpStats::*field,
+	unsigned long long n)
+{
+	PQContext& context = pqContext();
+
+	if (context.stats != nullptr)
+	{
+		context.stats->op[context.op].*field += n;
+	}
+}
+
+
+/**
+ * Counts and times one queue operation. Scopes nest, an operation
+ * implemented with another one is counted as both.
+ */
+class PQScope {
+
+public:
+	PQScope(PQStats& stats, PQOp op)
+		: saved(pqContext()), begin(std::chrono::steady_clock::now())
+	{
+		pqContext().stats = &stats;
+		pqContext().op = op;
+		stats.op[op].calls++;
+	}
+
+	~PQScope()
+	{
+		long long ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - begin).count();
+		int b = ns > 1 ? 63 - __builtin_clzll(ns) : 0;
+		PQContext& context = pqContext();
+
+		context.stats->op[context.op].latency[
+			b < PQ_LATENCY_BUCKETS ? b : PQ_LATENCY_BUCKETS - 1]++;
+		context = saved;
+	}
+
+private:
+	PQContext saved;
+	std::chrono::steady_clock::time_point begin;
+};
+
+#define PQ_SCOPE(stats, op) PQScope pqScope(stats, op)
+#define PQ_COUNT(field, n) pqCount(&PQOpStats::field, n)
+
+#else
+
+#define PQ_SCOPE(stats, op)
+#define PQ_COUNT(field, n)
+
+#endif
+
+#endif
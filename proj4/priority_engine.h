@@ -0,0 +1,1638 @@
+/**
+ * @file priority_engine.h - Heap engines that store the elements of a
+ * Minpriority queue.
+ *
+ * @brief - Minpriority turns every id into a small integer handle and
+ * leaves the ordering to an engine, so the engines only ever see handles
+ * and int keys. Each engine provides
+ *
+ *    void push(unsigned int handle, int key)       handle not queued yet
+ *    bool contains(unsigned int handle) const
+ *    void decrease(unsigned int handle, int key)   ignored unless smaller
+ *    unsigned int pop()                            queue must not be empty
+ *    size_t size() const
+ *    void pushAll(const EntryRun& run)             a push per entry
+ *    void takeAll(EntryRun& out)                   empties the engine
+ *
+ * and keeps, per handle, the heap slot it occupies, so decrease never
+ * searches. PointerHeap is the original layout, one heap allocated
+ * Element per entry and a vector of pointers, kept for comparison.
+ * ArrayHeap stores the entries by value in contiguous arrays; its Slots
+ * parameter chooses between key and handle side by side (PackedSlots) or
+ * in two parallel arrays (SplitSlots), where a sift compares keys
+ * without loading handles. DaryHeap gives every node D children in one
+ * cache line aligned group (heap_keys.h), which halves or thirds the
+ * depth of the tree and picks the smallest child with SIMD compares.
+ * PairingHeap and RadixHeap make decrease O(1), the operation that
+ * dominates shortest path and spanning tree runs; RadixHeap expects keys
+ * that never fall below the last one popped. BucketQueue and TimerWheel
+ * are for small integer keys, edge weights or timeout ticks: both keep a
+ * bucket per key value or key digit, push and decrease are O(1) and pop
+ * is O(1) amortized while the keys stay in range. pushAll and takeAll move
+ * whole runs of (handle, key) entries for bulk builds, merges and log
+ * replay: the array heaps append a long run unordered and heapify it
+ * bottom-up once, O(n + k), where pushing one by one costs O(k log n);
+ * takeAll hands back every entry, in no particular order, in O(n).
+ * With -DPQ_STATS the engines count their comparisons, moves, sift levels
+ * and scans into the queue operation running them (pq_stats.h).
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __PRIORITY_ENGINE_H
+#define __PRIORITY_ENGINE_H
+
+#include <algorithm>
+#include <climits>
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include "heap_keys.h"
+#include "pq_stats.h"
+
+typedef std::vector<std::pair<unsigned int, int> > EntryRun;
+
+/**
+ * Pushes a run one entry at a time, lowering the key of a handle that is
+ * already queued. Engines whose push is O(1) use it as their pushAll, the
+ * array heaps for runs short next to the heap.
+ */
+template <class Engine>
+void pushEach(Engine& engine, const EntryRun& run)
+{
+	for (size_t r = 0; r < run.size(); r++)
+	{
+		if (engine.contains(run[r].first))
+		{
+			engine.decrease(run[r].first, run[r].second);
+		}
+		else
+		{
+			engine.push(run[r].first, run[r].second);
+		}
+	}
+}
+
+/**
+ * Key and handle of an entry next to each other, 8 bytes per slot
+ */
+class PackedSlots {
+
+public:
+	int key(size_t i) const
+	{
+		return slots[i].key;
+	}
+
+	unsigned int handle(size_t i) const
+	{
+		return slots[i].handle;
+	}
+
+	void set(size_t i, int key, unsigned int handle)
+	{
+		slots[i].key = key;
+		slots[i].handle = handle;
+	}
+
+	void grow()
+	{
+		slots.push_back(Slot());
+	}
+
+	void shrink()
+	{
+		slots.pop_back();
+	}
+
+	void clear()
+	{
+		slots.clear();
+	}
+
+	size_t size() const
+	{
+		return slots.size();
+	}
+
+private:
+	struct Slot {
+
+		int key;
+		unsigned int handle;
+	};
+
+	std::vector<Slot> slots;
+};
+
+
+/**
+ * Keys and handles in parallel arrays, so comparisons touch only keys
+ */
+class SplitSlots {
+
+public:
+	int key(size_t i) const
+	{
+		return keys[i];
+	}
+
+	unsigned int handle(size_t i) const
+	{
+		return handles[i];
+	}
+
+	void set(size_t i, int key, unsigned int handle)
+	{
+		keys[i] = key;
+		handles[i] = handle;
+	}
+
+	void grow()
+	{
+		keys.push_back(0);
+		handles.push_back(0);
+	}
+
+	void shrink()
+	{
+		keys.pop_back();
+		handles.pop_back();
+	}
+
+	void clear()
+	{
+		keys.clear();
+		handles.clear();
+	}
+
+	size_t size() const
+	{
+		return keys.size();
+	}
+
+private:
+	std::vector<int> keys;
+	std::vector<unsigned int> handles;
+};
+
+
+/**
+ * Binary min-heap with its entries stored by value. Sifts move a hole
+ * instead of swapping, so each level writes one slot and one position.
+ */
+template <class Slots>
+class ArrayHeap {
+
+public:
+	void push(unsigned int handle, int key)
+	{
+		if (handle >= position.size())
+		{
+			position.resize(handle + 1, -1);
+		}
+
+		slots.grow();
+		siftUp(slots.size() - 1, key, handle);
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		if (run.size() < slots.size())
+		{
+			pushEach(*this, run);
+			return;
+		}
+
+		for (size_t r = 0; r < run.size(); r++)
+		{
+			unsigned int handle = run[r].first;
+			int key = run[r].second;
+
+			if (handle >= position.size())
+			{
+				position.resize(handle + 1, -1);
+			}
+
+			if (position[handle] < 0)
+			{
+				slots.grow();
+				place(slots.size() - 1, key, handle);
+			}
+			else if (key < slots.key(position[handle]))
+			{
+				slots.set(position[handle], key, handle);
+			}
+		}
+
+		PQ_COUNT(heapBuilds, 1);
+
+		for (size_t i = slots.size() / 2; i-- > 0; )
+		{
+			siftDown(i, slots.key(i), slots.handle(i));
+		}
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		for (size_t i = 0; i < slots.size(); i++)
+		{
+			out.push_back(std::make_pair(slots.handle(i), slots.key(i)));
+			position[slots.handle(i)] = -1;
+		}
+
+		slots.clear();
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return handle < position.size() && position[handle] >= 0;
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		size_t i = position[handle];
+
+		if (key < slots.key(i))
+		{
+			siftUp(i, key, handle);
+		}
+	}
+
+	unsigned int pop()
+	{
+		unsigned int top = slots.handle(0);
+		size_t last = slots.size() - 1;
+		int key = slots.key(last);
+		unsigned int handle = slots.handle(last);
+
+		position[top] = -1;
+		slots.shrink();
+
+		if (last > 0)
+		{
+			siftDown(0, key, handle);
+		}
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return slots.size();
+	}
+
+private:
+	Slots slots;
+	std::vector<int> position;   // handle -> slot, -1 when not queued
+
+	void place(size_t i, int key, unsigned int handle)
+	{
+		slots.set(i, key, handle);
+		position[handle] = (int)i;
+	}
+
+	void siftUp(size_t i, int key, unsigned int handle)
+	{
+		PQ_COUNT(sifts, 1);
+
+		while (i > 0)
+		{
+			size_t parent = (i - 1) / 2;
+
+			PQ_COUNT(comparisons, 1);
+
+			if (slots.key(parent) <= key)
+			{
+				break;
+			}
+
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			place(i, slots.key(parent), slots.handle(parent));
+			i = parent;
+		}
+
+		place(i, key, handle);
+	}
+
+	void siftDown(size_t i, int key, unsigned int handle)
+	{
+		size_t n = slots.size();
+
+		PQ_COUNT(sifts, 1);
+
+		for (;;)
+		{
+			size_t child = 2 * i + 1;
+
+			if (child >= n)
+			{
+				break;
+			}
+
+			PQ_COUNT(comparisons, child + 1 < n ? 2 : 1);
+
+			if (child + 1 < n && slots.key(child + 1) < slots.key(child))
+			{
+				child++;
+			}
+
+			if (slots.key(child) >= key)
+			{
+				break;
+			}
+
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			place(i, slots.key(child), slots.handle(child));
+			i = child;
+		}
+
+		place(i, key, handle);
+	}
+};
+
+
+/**
+ * Min-heap with D children per node. Keys live in AlignedKeys, handles
+ * in a parallel array, and sifts move a hole like ArrayHeap.
+ */
+template <unsigned D>
+class DaryHeap {
+
+	static_assert(D >= 2 && (D & (D - 1)) == 0, "arity is a power of two");
+
+public:
+	DaryHeap() : count(0)
+	{
+
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		if (handle >= position.size())
+		{
+			position.resize(handle + 1, -1);
+		}
+
+		// the last node's sibling group, read whole by siftDown
+		keys.reserve(slot(count) + 2 * D);
+		handles.push_back(0);
+		siftUp(count++, key, handle);
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		if (run.size() < count)
+		{
+			pushEach(*this, run);
+			return;
+		}
+
+		keys.reserve(slot(count + run.size()) + 2 * D);
+
+		for (size_t r = 0; r < run.size(); r++)
+		{
+			unsigned int handle = run[r].first;
+			int key = run[r].second;
+
+			if (handle >= position.size())
+			{
+				position.resize(handle + 1, -1);
+			}
+
+			if (position[handle] < 0)
+			{
+				handles.push_back(0);
+				place(count++, key, handle);
+			}
+			else if (key < keys[slot(position[handle])])
+			{
+				keys[slot(position[handle])] = key;
+			}
+		}
+
+		heapify();
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		for (size_t i = 0; i < count; i++)
+		{
+			out.push_back(std::make_pair(handles[i], keys[slot(i)]));
+			position[handles[i]] = -1;
+			keys[slot(i)] = INT_MAX;
+		}
+
+		handles.clear();
+		count = 0;
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return handle < position.size() && position[handle] >= 0;
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		size_t i = position[handle];
+
+		if (key < keys[slot(i)])
+		{
+			siftUp(i, key, handle);
+		}
+	}
+
+	unsigned int pop()
+	{
+		unsigned int top = handles[0];
+		size_t last = --count;
+		int key = keys[slot(last)];
+		unsigned int handle = handles[last];
+
+		keys[slot(last)] = INT_MAX;
+		handles.pop_back();
+		position[top] = -1;
+
+		if (last > 0)
+		{
+			siftDown(0, key, handle);
+		}
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	AlignedKeys keys;
+	std::vector<unsigned int> handles;
+	std::vector<int> position;   // handle -> node, -1 when not queued
+	size_t count;
+
+	// node i has its children at D * i + 1 ... D * i + D, shifting every
+	// key by D - 1 slots starts each sibling group on a multiple of D
+	static size_t slot(size_t i)
+	{
+		return i + D - 1;
+	}
+
+	void place(size_t i, int key, unsigned int handle)
+	{
+		keys[slot(i)] = key;
+		handles[i] = handle;
+		position[handle] = (int)i;
+	}
+
+	void siftUp(size_t i, int key, unsigned int handle)
+	{
+		PQ_COUNT(sifts, 1);
+
+		while (i > 0)
+		{
+			size_t parent = (i - 1) / D;
+
+			PQ_COUNT(comparisons, 1);
+
+			if (keys[slot(parent)] <= key)
+			{
+				break;
+			}
+
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			place(i, keys[slot(parent)], handles[parent]);
+			i = parent;
+		}
+
+		place(i, key, handle);
+	}
+
+	// Floyd's construction, every parent sifted down from the last one
+	void heapify()
+	{
+		PQ_COUNT(heapBuilds, 1);
+
+		for (size_t i = count > 1 ? (count - 2) / D + 1 : 0; i-- > 0; )
+		{
+			siftDown(i, keys[slot(i)], handles[i]);
+		}
+	}
+
+	void siftDown(size_t i, int key, unsigned int handle)
+	{
+		PQ_COUNT(sifts, 1);
+
+		for (;;)
+		{
+			size_t first = D * i + 1;
+
+			if (first >= count)
+			{
+				break;
+			}
+
+			const int *group = &keys[slot(first)];
+			size_t child = first + smallestKey<D>(group);
+
+			// the D - 1 of the group are done as one or two SIMD compares
+			PQ_COUNT(comparisons, D);
+
+			if (keys[slot(child)] >= key)
+			{
+				break;
+			}
+
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			place(i, keys[slot(child)], handles[child]);
+			i = child;
+		}
+
+		place(i, key, handle);
+	}
+};
+
+
+/**
+ * The original layout: a vector of pointers to separately allocated
+ * elements, each of which remembers its own slot
+ */
+class PointerHeap {
+
+public:
+	~PointerHeap()
+	{
+		for (Element *ele : heap)
+		{
+			delete ele;
+		}
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		if (handle >= byHandle.size())
+		{
+			byHandle.resize(handle + 1, nullptr);
+		}
+
+		Element *ele = new Element;
+
+		ele->key = key;
+		ele->handle = handle;
+		ele->pos = heap.size();
+
+		heap.push_back(ele);
+		byHandle[handle] = ele;
+		siftUp(ele->pos);
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		if (run.size() < heap.size())
+		{
+			pushEach(*this, run);
+			return;
+		}
+
+		for (size_t r = 0; r < run.size(); r++)
+		{
+			unsigned int handle = run[r].first;
+
+			if (handle >= byHandle.size())
+			{
+				byHandle.resize(handle + 1, nullptr);
+			}
+
+			if (byHandle[handle] == nullptr)
+			{
+				Element *ele = new Element;
+
+				ele->key = run[r].second;
+				ele->handle = handle;
+				ele->pos = heap.size();
+
+				heap.push_back(ele);
+				byHandle[handle] = ele;
+			}
+			else if (run[r].second < byHandle[handle]->key)
+			{
+				byHandle[handle]->key = run[r].second;
+			}
+		}
+
+		PQ_COUNT(heapBuilds, 1);
+
+		for (size_t i = heap.size() / 2; i-- > 0; )
+		{
+			minHeapify(i);
+		}
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		for (Element *ele : heap)
+		{
+			out.push_back(std::make_pair(ele->handle, ele->key));
+			byHandle[ele->handle] = nullptr;
+			delete ele;
+		}
+
+		heap.clear();
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return handle < byHandle.size() && byHandle[handle] != nullptr;
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		Element *ele = byHandle[handle];
+
+		if (key < ele->key)
+		{
+			ele->key = key;
+			siftUp(ele->pos);
+		}
+	}
+
+	unsigned int pop()
+	{
+		Element *ele = heap[0];
+		unsigned int top = ele->handle;
+
+		exchange(0, heap.size() - 1);
+		heap.pop_back();
+		byHandle[top] = nullptr;
+		minHeapify(0);
+
+		delete ele;
+		return top;
+	}
+
+	size_t size() const
+	{
+		return heap.size();
+	}
+
+private:
+	struct Element {
+
+		int key;
+		unsigned int handle;
+		size_t pos;
+	};
+
+	std::vector<Element*> heap;
+	std::vector<Element*> byHandle;
+
+	void exchange(size_t i, size_t j)
+	{
+		std::swap(heap[i], heap[j]);
+		heap[i]->pos = i;
+		heap[j]->pos = j;
+	}
+
+	void siftUp(size_t i)
+	{
+		PQ_COUNT(sifts, 1);
+
+		while (i > 0)
+		{
+			PQ_COUNT(comparisons, 1);
+
+			if (heap[(i - 1) / 2]->key <= heap[i]->key)
+			{
+				break;
+			}
+
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			exchange(i, (i - 1) / 2);
+			i = (i - 1) / 2;
+		}
+	}
+
+	void minHeapify(size_t i)
+	{
+		size_t l = 2 * i + 1;
+		size_t r = 2 * i + 2;
+		size_t min = i;
+
+		PQ_COUNT(comparisons, (l < heap.size()) + (r < heap.size()));
+
+		if (l < heap.size() && heap[l]->key < heap[min]->key)
+		{
+			min = l;
+		}
+
+		if (r < heap.size() && heap[r]->key < heap[min]->key)
+		{
+			min = r;
+		}
+
+		if (min != i)
+		{
+			PQ_COUNT(swaps, 1);
+			PQ_COUNT(siftLevels, 1);
+			exchange(i, min);
+			minHeapify(min);
+		}
+	}
+};
+
+
+/**
+ * Pairing heap: a multiway tree where insert and decrease only link a
+ * tree below the root, O(1), and pop pays for the restructuring with a
+ * two-pass merge of the root's children, O(log n) amortized. Nodes live
+ * in an array indexed by handle and link to each other by handle.
+ */
+class PairingHeap {
+
+public:
+	PairingHeap() : root(NONE), count(0)
+	{
+
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		if (handle >= nodes.size())
+		{
+			nodes.resize(handle + 1);
+		}
+
+		Node& node = nodes[handle];
+
+		node.key = key;
+		node.child = NONE;
+		node.sibling = NONE;
+		node.prev = NONE;
+		node.queued = true;
+
+		root = root == NONE ? (int)handle : link(root, handle);
+		count++;
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		pushEach(*this, run);
+	}
+
+	// walks the tree from the root, children and siblings alike
+	void takeAll(EntryRun& out)
+	{
+		pairs.clear();
+
+		if (root != NONE)
+		{
+			pairs.push_back(root);
+		}
+
+		while (!pairs.empty())
+		{
+			int i = pairs.back();
+
+			pairs.pop_back();
+			out.push_back(std::make_pair((unsigned int)i, nodes[i].key));
+			nodes[i].queued = false;
+
+			if (nodes[i].child != NONE)
+			{
+				pairs.push_back(nodes[i].child);
+			}
+
+			if (nodes[i].sibling != NONE)
+			{
+				pairs.push_back(nodes[i].sibling);
+			}
+		}
+
+		root = NONE;
+		count = 0;
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return handle < nodes.size() && nodes[handle].queued;
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		Node& node = nodes[handle];
+
+		if (key >= node.key)
+		{
+			return;
+		}
+
+		node.key = key;
+
+		if ((int)handle != root)
+		{
+			cut(handle);
+			root = link(root, handle);
+		}
+	}
+
+	unsigned int pop()
+	{
+		unsigned int top = root;
+
+		nodes[top].queued = false;
+		root = mergePairs(nodes[top].child);
+		count--;
+
+		if (root != NONE)
+		{
+			nodes[root].prev = NONE;
+		}
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	static const int NONE = -1;
+
+	struct Node {
+
+		int key;
+		int child;       // leftmost child
+		int sibling;     // next sibling to the right
+		int prev;        // left sibling, or parent for a leftmost child
+		bool queued;
+	};
+
+	std::vector<Node> nodes;
+	std::vector<int> pairs;      // scratch for mergePairs
+	int root;
+	size_t count;
+
+	// makes the root with the larger key the leftmost child of the other
+	int link(int a, int b)
+	{
+		PQ_COUNT(comparisons, 1);
+
+		if (nodes[b].key < nodes[a].key)
+		{
+			std::swap(a, b);
+		}
+
+		Node& parent = nodes[a];
+		Node& child = nodes[b];
+
+		child.sibling = parent.child;
+		child.prev = a;
+
+		if (parent.child != NONE)
+		{
+			nodes[parent.child].prev = b;
+		}
+
+		parent.child = b;
+		parent.sibling = NONE;
+		parent.prev = NONE;
+
+		return a;
+	}
+
+	// detaches the subtree rooted at i from its parent or left sibling
+	void cut(int i)
+	{
+		Node& node = nodes[i];
+		Node& prev = nodes[node.prev];
+
+		if (prev.child == i)
+		{
+			prev.child = node.sibling;
+		}
+		else
+		{
+			prev.sibling = node.sibling;
+		}
+
+		if (node.sibling != NONE)
+		{
+			nodes[node.sibling].prev = node.prev;
+		}
+
+		node.sibling = NONE;
+		node.prev = NONE;
+	}
+
+	// links the children pairwise left to right, then folds right to left
+	int mergePairs(int first)
+	{
+		pairs.clear();
+
+		while (first != NONE)
+		{
+			int second = nodes[first].sibling;
+			int next = second == NONE ? NONE : nodes[second].sibling;
+
+			nodes[first].sibling = NONE;
+
+			if (second != NONE)
+			{
+				nodes[second].sibling = NONE;
+				first = link(first, second);
+			}
+
+			pairs.push_back(first);
+			first = next;
+		}
+
+		if (pairs.empty())
+		{
+			return NONE;
+		}
+
+		int merged = pairs.back();
+
+		for (size_t i = pairs.size() - 1; i-- > 0;)
+		{
+			merged = link(pairs[i], merged);
+		}
+
+		return merged;
+	}
+};
+
+
+/**
+ * Radix heap for integer keys used monotonically, as in Dijkstra's
+ * algorithm: no key pushed or decreased below the last popped one. A key
+ * sits in the bucket numbered by the highest bit in which it differs from
+ * the last popped key, so push and decrease are O(1) and each key moves
+ * to a lower bucket at most 32 times before it is popped. A key below the
+ * last popped one, which Prim's algorithm produces, is still handled
+ * correctly by rebucketing every entry around it, at O(n) each time.
+ */
+class RadixHeap {
+
+public:
+	RadixHeap() : last(0), count(0)
+	{
+
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		if (handle >= entries.size())
+		{
+			entries.resize(handle + 1);
+		}
+
+		entries[handle].key = order(key);
+		place(handle);
+		count++;
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		pushEach(*this, run);
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		for (std::vector<unsigned int>& bucket : buckets)
+		{
+			for (unsigned int handle : bucket)
+			{
+				out.push_back(std::make_pair(handle,
+					(int)(entries[handle].key ^ 0x80000000u)));
+				entries[handle].bucket = -1;
+			}
+
+			bucket.clear();
+		}
+
+		count = 0;
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return handle < entries.size() && entries[handle].bucket >= 0;
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		unsigned int ordered = order(key);
+
+		if (ordered >= entries[handle].key)
+		{
+			return;
+		}
+
+		remove(handle);
+		entries[handle].key = ordered;
+		place(handle);
+	}
+
+	unsigned int pop()
+	{
+		if (buckets[0].empty())
+		{
+			int b = 1;
+
+			while (buckets[b].empty())
+			{
+				b++;
+			}
+
+			std::vector<unsigned int> spill;
+
+			spill.swap(buckets[b]);
+			PQ_COUNT(scans, b + spill.size());
+			last = entries[spill[0]].key;
+
+			for (unsigned int handle : spill)
+			{
+				if (entries[handle].key < last)
+				{
+					last = entries[handle].key;
+				}
+			}
+
+			for (unsigned int handle : spill)
+			{
+				place(handle);
+			}
+		}
+
+		unsigned int top = buckets[0].back();
+
+		buckets[0].pop_back();
+		entries[top].bucket = -1;
+		count--;
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	struct Entry {
+
+		Entry() : key(0), bucket(-1), index(0)
+		{
+
+		}
+
+		unsigned int key;     // order(key), compares like the int
+		int bucket;           // -1 when not queued
+		size_t index;         // position in its bucket
+	};
+
+	std::vector<Entry> entries;
+	std::vector<unsigned int> buckets[33];
+	unsigned int last;
+	size_t count;
+
+	// maps INT_MIN ... INT_MAX onto 0 ... UINT_MAX keeping the order
+	static unsigned int order(int key)
+	{
+		return (unsigned int)key ^ 0x80000000u;
+	}
+
+	void place(unsigned int handle)
+	{
+		Entry& entry = entries[handle];
+
+		if (entry.key < last)
+		{
+			rebucket(entry.key);
+		}
+
+		int b = entry.key == last ? 0 : 32 - __builtin_clz(entry.key ^ last);
+
+		entry.bucket = b;
+		entry.index = buckets[b].size();
+		buckets[b].push_back(handle);
+	}
+
+	void remove(unsigned int handle)
+	{
+		Entry& entry = entries[handle];
+		std::vector<unsigned int>& bucket = buckets[entry.bucket];
+		unsigned int moved = bucket.back();
+
+		bucket[entry.index] = moved;
+		entries[moved].index = entry.index;
+		bucket.pop_back();
+		entry.bucket = -1;
+	}
+
+	// a key fell below last: make it the new base and sort every entry
+	// into the bucket it belongs to relative to that base
+	void rebucket(unsigned int base)
+	{
+		std::vector<unsigned int> all;
+
+		for (std::vector<unsigned int>& bucket : buckets)
+		{
+			all.insert(all.end(), bucket.begin(), bucket.end());
+			bucket.clear();
+		}
+
+		last = base;
+		PQ_COUNT(heapBuilds, 1);
+		PQ_COUNT(scans, all.size());
+
+		for (unsigned int handle : all)
+		{
+			place(handle);
+		}
+	}
+};
+
+
+/**
+ * Doubly linked bucket lists threaded through one array indexed by
+ * handle, so a handle joins or leaves a bucket in O(1) and never
+ * allocates. BucketQueue and TimerWheel keep their entries here.
+ */
+class BucketLists {
+
+public:
+	static constexpr int NONE = -1;
+
+	explicit BucketLists(size_t buckets) : heads(buckets, NONE)
+	{
+
+	}
+
+	bool queued(unsigned int handle) const
+	{
+		return handle < links.size() && links[handle].bucket != NONE;
+	}
+
+	int key(unsigned int handle) const
+	{
+		return links[handle].key;
+	}
+
+	int head(int bucket) const
+	{
+		return heads[bucket];
+	}
+
+	int next(unsigned int handle) const
+	{
+		return links[handle].next;
+	}
+
+	void add(unsigned int handle, int key, int bucket)
+	{
+		if (handle >= links.size())
+		{
+			links.resize(handle + 1);
+		}
+
+		Link& link = links[handle];
+
+		link.key = key;
+		link.bucket = bucket;
+		link.prev = NONE;
+		link.next = heads[bucket];
+
+		if (link.next != NONE)
+		{
+			links[link.next].prev = handle;
+		}
+
+		heads[bucket] = handle;
+	}
+
+	// unlinks handle, returns the bucket it was in
+	int remove(unsigned int handle)
+	{
+		Link& link = links[handle];
+		int bucket = link.bucket;
+
+		if (link.prev != NONE)
+		{
+			links[link.prev].next = link.next;
+		}
+		else
+		{
+			heads[bucket] = link.next;
+		}
+
+		if (link.next != NONE)
+		{
+			links[link.next].prev = link.prev;
+		}
+
+		link.bucket = NONE;
+		return bucket;
+	}
+
+	// appends every handle of a bucket to out and empties the bucket
+	void take(int bucket, std::vector<unsigned int>& out)
+	{
+		for (int h = heads[bucket]; h != NONE; h = links[h].next)
+		{
+			out.push_back(h);
+			links[h].bucket = NONE;
+		}
+
+		heads[bucket] = NONE;
+	}
+
+private:
+	struct Link {
+
+		Link() : key(0), bucket(NONE), prev(NONE), next(NONE)
+		{
+
+		}
+
+		int key;
+		int bucket;      // NONE when not queued
+		int prev;
+		int next;
+	};
+
+	std::vector<Link> links;
+	std::vector<int> heads;
+};
+
+
+/**
+ * Dial's bucket queue for keys that stay within Range of each other, such
+ * as distances over edge weights below Range or timeouts a bounded number
+ * of ticks ahead. Range buckets form a circular window [base, base +
+ * Range) with one key value per bucket; push and decrease link a handle
+ * into its bucket in O(1) and pop scans forward from base, O(1) amortized
+ * while popped keys only grow. Keys past the window wait in a spill
+ * bucket until the window runs empty and is rebuilt at the smallest of
+ * them, so the window never slides over a spilled key. A key below base,
+ * as Prim's algorithm produces, just moves base down when every queued
+ * key still fits the window, and otherwise rebuilds the window around it
+ * in O(n + Range).
+ */
+template <unsigned Range>
+class BucketQueue {
+
+	static_assert(Range >= 2 && (Range & (Range - 1)) == 0,
+		"range is a power of two");
+
+public:
+	BucketQueue()
+		: lists(Range + 1), base(0), limit(Range), high(LLONG_MIN), count(0)
+	{
+
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		place(handle, key);
+		count++;
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		pushEach(*this, run);
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		std::vector<unsigned int> all;
+
+		for (unsigned b = 0; b <= Range; b++)
+		{
+			lists.take(b, all);
+		}
+
+		for (unsigned int handle : all)
+		{
+			out.push_back(std::make_pair(handle, lists.key(handle)));
+		}
+
+		count = 0;
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return lists.queued(handle);
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		if (key < lists.key(handle))
+		{
+			lists.remove(handle);
+			place(handle, key);
+		}
+	}
+
+	unsigned int pop()
+	{
+		while (lists.head(bucket(base)) == BucketLists::NONE)
+		{
+			PQ_COUNT(scans, 1);
+
+			if (++base == limit)
+			{
+				refill();
+			}
+		}
+
+		unsigned int top = lists.head(bucket(base));
+
+		lists.remove(top);
+		count--;
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	static const unsigned SPILL = Range;
+
+	BucketLists lists;
+	long long base;      // smallest key the window holds
+	long long limit;     // keys from here on spill, at most base + Range
+	long long high;      // no bucketed key is larger
+	size_t count;
+
+	static unsigned bucket(long long key)
+	{
+		return (unsigned long long)key & (Range - 1);
+	}
+
+	void place(unsigned int handle, int key)
+	{
+		if (key < base)
+		{
+			if (high < (long long)key + Range)
+			{
+				base = key;
+				limit = std::min(limit, base + Range);
+			}
+			else
+			{
+				rebuild(key);
+			}
+		}
+
+		if (key < limit)
+		{
+			lists.add(handle, key, bucket(key));
+			high = std::max(high, (long long)key);
+		}
+		else
+		{
+			lists.add(handle, key, SPILL);
+		}
+	}
+
+	// the window ran empty: move it to the smallest overflow key
+	void refill()
+	{
+		long long smallest = LLONG_MAX;
+
+		for (int h = lists.head(SPILL); h != BucketLists::NONE;
+			h = lists.next(h))
+		{
+			PQ_COUNT(scans, 1);
+			smallest = std::min(smallest, (long long)lists.key(h));
+		}
+
+		rebuild(smallest);
+	}
+
+	// makes newBase the start of the window and places every entry again
+	void rebuild(long long newBase)
+	{
+		std::vector<unsigned int> all;
+
+		for (unsigned b = 0; b <= Range; b++)
+		{
+			lists.take(b, all);
+		}
+
+		base = newBase;
+		limit = newBase + Range;
+		high = LLONG_MIN;
+		PQ_COUNT(heapBuilds, 1);
+		PQ_COUNT(scans, Range + all.size());
+
+		for (unsigned int handle : all)
+		{
+			place(handle, lists.key(handle));
+		}
+	}
+};
+
+
+/**
+ * Hierarchical timer wheel: six wheels of 64 slots, each wheel one base
+ * 64 digit of the key. A key sits on the wheel of the highest digit in
+ * which it differs from now, in the slot of its own digit there, and a
+ * bit per slot marks the occupied ones, so push and decrease are O(1) and
+ * the next slot is one count of trailing zeros away. Popping from the
+ * lowest wheel is O(1); when it is empty the first occupied slot of the
+ * next wheel cascades down, and since a key only ever moves to a lower
+ * wheel, pop is O(1) amortized. Like RadixHeap it expects keys not to
+ * fall below the last popped one and rebuilds in O(n) when one does.
+ */
+class TimerWheel {
+
+public:
+	TimerWheel() : lists(WHEELS * SLOTS), now(0), count(0)
+	{
+		for (int w = 0; w < WHEELS; w++)
+		{
+			occupied[w] = 0;
+		}
+	}
+
+	void push(unsigned int handle, int key)
+	{
+		place(handle, key);
+		count++;
+	}
+
+	void pushAll(const EntryRun& run)
+	{
+		pushEach(*this, run);
+	}
+
+	void takeAll(EntryRun& out)
+	{
+		std::vector<unsigned int> all;
+
+		for (int w = 0; w < WHEELS; w++)
+		{
+			for (int s = 0; s < SLOTS; s++)
+			{
+				lists.take(w * SLOTS + s, all);
+			}
+
+			occupied[w] = 0;
+		}
+
+		for (unsigned int handle : all)
+		{
+			out.push_back(std::make_pair(handle, lists.key(handle)));
+		}
+
+		count = 0;
+	}
+
+	bool contains(unsigned int handle) const
+	{
+		return lists.queued(handle);
+	}
+
+	void decrease(unsigned int handle, int key)
+	{
+		if (key < lists.key(handle))
+		{
+			remove(handle);
+			place(handle, key);
+		}
+	}
+
+	unsigned int pop()
+	{
+		int w = 0;
+
+		while (occupied[w] == 0)
+		{
+			w++;
+		}
+
+		PQ_COUNT(scans, w);
+
+		if (w > 0)
+		{
+			cascade(w);
+		}
+
+		unsigned int top = lists.head(__builtin_ctzll(occupied[0]));
+
+		remove(top);
+		count--;
+
+		return top;
+	}
+
+	size_t size() const
+	{
+		return count;
+	}
+
+private:
+	static const int WHEELS = 6;
+	static const int SLOTS = 64;
+
+	BucketLists lists;
+	unsigned long long occupied[WHEELS];   // bit per non-empty slot
+	unsigned int now;                      // order of the reference key
+	size_t count;
+
+	// maps INT_MIN ... INT_MAX onto 0 ... UINT_MAX keeping the order
+	static unsigned int order(int key)
+	{
+		return (unsigned int)key ^ 0x80000000u;
+	}
+
+	void place(unsigned int handle, int key)
+	{
+		unsigned int ordered = order(key);
+
+		if (ordered < now)
+		{
+			rebuild(ordered);
+		}
+
+		int w = ordered == now ? 0 : (31 - __builtin_clz(ordered ^ now)) / 6;
+		int s = (ordered >> (6 * w)) & (SLOTS - 1);
+
+		lists.add(handle, key, w * SLOTS + s);
+		occupied[w] |= 1ULL << s;
+	}
+
+	void remove(unsigned int handle)
+	{
+		int slot = lists.remove(handle);
+
+		if (lists.head(slot) == BucketLists::NONE)
+		{
+			occupied[slot / SLOTS] &= ~(1ULL << (slot % SLOTS));
+		}
+	}
+
+	// moves now to the smallest key of the first occupied slot of wheel w
+	// and places that slot's keys again, on lower wheels
+	void cascade(int w)
+	{
+		int s = __builtin_ctzll(occupied[w]);
+		std::vector<unsigned int> due;
+
+		lists.take(w * SLOTS + s, due);
+		occupied[w] &= ~(1ULL << s);
+		PQ_COUNT(scans, due.size());
+		now = order(lists.key(due[0]));
+
+		for (unsigned int handle : due)
+		{
+			now = std::min(now, order(lists.key(handle)));
+		}
+
+		for (unsigned int handle : due)
+		{
+			place(handle, lists.key(handle));
+		}
+	}
+
+	// a key fell below now: make it the reference and place every entry
+	// again relative to it
+	void rebuild(unsigned int base)
+	{
+		std::vector<unsigned int> all;
+
+		for (int w = 0; w < WHEELS; w++)
+		{
+			for (int s = 0; s < SLOTS; s++)
+			{
+				lists.take(w * SLOTS + s, all);
+			}
+
+			occupied[w] = 0;
+		}
+
+		now = base;
+		PQ_COUNT(heapBuilds, 1);
+		PQ_COUNT(scans, WHEELS * SLOTS + all.size());
+
+		for (unsigned int handle : all)
+		{
+			place(handle, lists.key(handle));
+		}
+	}
+};
+
+#endif
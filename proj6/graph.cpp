@@ -381,6 +381,9 @@ void Graph::mst(string start)
       print(u);
    }
    cout<<total<<endl;
+#ifdef PQ_STATS
+   minQ->stats().dump(cerr);
+#endif
 }
 
 
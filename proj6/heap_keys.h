@@ -0,0 +1,190 @@
+/**
+ * @file heap_keys.h - Cache line aligned key storage for d-ary heaps.
+ *
+ * @brief - A d-ary heap keeps the D children of a node next to each
+ * other. AlignedKeys hands out a 64-byte aligned buffer; a heap that
+ * offsets its nodes so every group of siblings starts on a multiple of
+ * D slots never has a group straddle a cache line with D = 4 or 8, and
+ * smallestKey picks the least child of a group with one or two SSE2
+ * compares instead of D - 1 branches. Slots past the end of the heap
+ * hold INT_MAX, which lets the last group be compared whole.
+ *
+ * @author Alex Moxon
+ * @date 10/19/26
+ */
+
+#ifndef __HEAP_KEYS_H
+#define __HEAP_KEYS_H
+
+#include <cstddef>
+#include <cstdlib>
+#include <cstring>
+#include <climits>
+#include <new>
+#include <utility>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+static const size_t CACHE_LINE = 64;
+
+/**
+ * Int keys in a cache line aligned buffer padded with INT_MAX
+ */
+class AlignedKeys {
+
+public:
+	AlignedKeys() : keys(nullptr), capacity(0)
+	{
+
+	}
+
+	~AlignedKeys()
+	{
+		free(keys);
+	}
+
+	AlignedKeys(const AlignedKeys& other) : keys(nullptr), capacity(0)
+	{
+		reserve(other.capacity);
+		memcpy(keys, other.keys, capacity * sizeof(int));
+	}
+
+	AlignedKeys& operator=(AlignedKeys other)
+	{
+		std::swap(keys, other.keys);
+		std::swap(capacity, other.capacity);
+		return *this;
+	}
+
+	int& operator[](size_t i)
+	{
+		return keys[i];
+	}
+
+	int operator[](size_t i) const
+	{
+		return keys[i];
+	}
+
+	/**
+	 * Makes slots [0, slots) addressable; new slots read INT_MAX
+	 *
+	 * @param slots - Number of slots needed
+	 */
+	void reserve(size_t slots)
+	{
+		if (slots <= capacity)
+		{
+			return;
+		}
+
+		size_t grown = capacity > 0 ? capacity : CACHE_LINE / sizeof(int);
+
+		while (grown < slots)
+		{
+			grown *= 2;
+		}
+
+		void *buffer = nullptr;
+
+		if (posix_memalign(&buffer, CACHE_LINE, grown * sizeof(int)) != 0)
+		{
+			throw std::bad_alloc();
+		}
+
+		int *resized = (int *)buffer;
+
+		if (capacity > 0)
+		{
+			memcpy(resized, keys, capacity * sizeof(int));
+		}
+
+		for (size_t i = capacity; i < grown; i++)
+		{
+			resized[i] = INT_MAX;
+		}
+
+		free(keys);
+		keys = resized;
+		capacity = grown;
+	}
+
+private:
+	int *keys;
+	size_t capacity;
+};
+
+
+/**
+ * Position of the smallest of D keys, the first one on ties, so a real
+ * child always wins over INT_MAX padding with the same value
+ *
+ * @param keys - D keys starting at a multiple of D slots
+ */
+template <unsigned D>
+inline unsigned smallestKey(const int *keys)
+{
+	unsigned smallest = 0;
+
+	for (unsigned k = 1; k < D; k++)
+	{
+		if (keys[k] < keys[smallest])
+		{
+			smallest = k;
+		}
+	}
+
+	return smallest;
+}
+
+#ifdef __SSE2__
+
+/**
+ * Lane-wise minimum of signed ints, SSE2 has no pminsd
+ */
+inline __m128i lesserKeys(__m128i a, __m128i b)
+{
+	__m128i less = _mm_cmplt_epi32(a, b);
+
+	return _mm_or_si128(_mm_and_si128(less, a), _mm_andnot_si128(less, b));
+}
+
+
+/**
+ * The smallest key of a vector in every lane
+ */
+inline __m128i spreadMinimum(__m128i v)
+{
+	v = lesserKeys(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1)));
+
+	return lesserKeys(v, _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2)));
+}
+
+
+template <>
+inline unsigned smallestKey<4>(const int *keys)
+{
+	__m128i v = _mm_load_si128((const __m128i *)keys);
+	__m128i equal = _mm_cmpeq_epi32(v, spreadMinimum(v));
+
+	return __builtin_ctz(_mm_movemask_ps(_mm_castsi128_ps(equal)));
+}
+
+
+template <>
+inline unsigned smallestKey<8>(const int *keys)
+{
+	__m128i low = _mm_load_si128((const __m128i *)keys);
+	__m128i high = _mm_load_si128((const __m128i *)(keys + 4));
+	__m128i minimum = spreadMinimum(lesserKeys(low, high));
+	int mask = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(low, minimum)))
+		| _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(high, minimum))) << 4;
+
+	return __builtin_ctz(mask);
+}
+
+#endif
+
+#endif
@@ -13,17 +13,29 @@
 #include <string>
 #include <vector>
 #include <sstream>
-#include <cmath>
+#include <climits>
+#include <cassert>
 
 using namespace std;
 
+// -DMINPQ_DEBUG verifies the whole heap after every change, O(n) each
+#ifdef MINPQ_DEBUG
+#define CHECK_HEAP() assert(isHeap())
+#else
+#define CHECK_HEAP()
+#endif
+
 
 /**
 * @brief Constructor for MinPriorityQ minHeap
 */
-MinPriorityQ::MinPriorityQ(int hSize)
+template <unsigned D>
+BasicMinPriorityQ<D>::BasicMinPriorityQ(int hSize)
 {
-   minHeap.reserve(hSize);
+   ids.reserve(hSize);
+   nodes.reserve(hSize);
+   position.reserve(hSize);
+   keys.reserve(slot(hSize) + 2 * D);
    this->hSize = 0;
 }
 
@@ -31,26 +43,109 @@ MinPriorityQ::MinPriorityQ(int hSize)
 /**
 * @brief Destructor for MinPriorityQ minHeap
 */
-MinPriorityQ::~MinPriorityQ()
+template <unsigned D>
+BasicMinPriorityQ<D>::~BasicMinPriorityQ()
 {
 
 }
 
 
 /**
- * @brief Insert element into minheap, sort
+ * @brief Return the handle of an id, giving it the next one the first
+ * time it is seen
+ *
+ * @param id - Heap ID
+ *
+ * @return Dense handle of the id
+ */
+template <unsigned D>
+int BasicMinPriorityQ<D>::intern(const string& id)
+{
+   auto found = handles.find(id);
+
+   if(found != handles.end())
+   {
+      return found->second;
+   }
+
+   int handle = (int)ids.size();
+   handles.emplace(id, handle);
+   ids.push_back(id);
+   position.push_back(0);
+
+   if(handle % 64 == 0)
+   {
+      queued.push_back(0);
+   }
+   return handle;
+}
+
+
+/**
+ * @brief Whether a handle is in the queue, one bit test
+ *
+ * @param handle - Handle to test
+ *
+ * @return true if queued
+ */
+template <unsigned D>
+bool BasicMinPriorityQ<D>::inQueue(int handle)
+{
+   return (queued[handle / 64] >> (handle % 64)) & 1;
+}
+
+
+/**
+ * @brief Set or clear the queued bit of a handle
+ *
+ * @param handle - Handle to mark
+ * @param in - true when the handle enters the queue
+ */
+template <unsigned D>
+void BasicMinPriorityQ<D>::setQueued(int handle, bool in)
+{
+   unsigned long long bit = 1ULL << (handle % 64);
+
+   if(in)
+   {
+      queued[handle / 64] |= bit;
+   }
+   else
+   {
+      queued[handle / 64] &= ~bit;
+   }
+}
+
+
+/**
+ * @brief Insert element into minheap and sift it up to its place. An id
+ * that is already queued keeps its one node, its key only decreases.
  *
  * @param id - Heap ID
  * @param key - Heap key
  */
-void MinPriorityQ::insert(string id, int key)
+template <unsigned D>
+void BasicMinPriorityQ<D>::insert(const string& id, int key)
 {
-   Element x;
-   x.id = id;
-   x.key = key;
-   minHeap.push_back(x);
+   PQ_SCOPE(counters, PQ_INSERT);
+
+   int handle = intern(id);
+
+   if(inQueue(handle))
+   {
+      decreaseKey(id, key);
+      return;
+   }
+
+   nodes.push_back(handle);
    hSize++;
-   minHeap.resize(hSize);
+   // room for the whole sibling group of the new node's first child
+   keys.reserve(slot(hSize) + 2 * D);
+   keys[slot(hSize)] = key;
+   position[handle] = hSize;
+   setQueued(handle, true);
+   siftUp(hSize);
+   CHECK_HEAP();
 }
 
 
@@ -59,37 +154,80 @@ void MinPriorityQ::insert(string id, int key)
  *
  * @param i - Index to get parent of
  *
- * @return Key of the parent
+ * @return Index of the parent
  */
-int MinPriorityQ::parent(int i)
+template <unsigned D>
+int BasicMinPriorityQ<D>::parent(int i)
 {
-   return floor(i/2);
+   return (i - 2) / (int)D + 1;
 }
 
 
 /**
- * @brief Return the left child of a node by index
+ * @brief Return the first of the D children of a node by index
  *
- * @param i - Index to get left child of
+ * @param i - Index to get first child of
  *
- * @return Key of the left child
+ * @return Index of the first child, its siblings follow it
  */
-int MinPriorityQ::left(int i)
+template <unsigned D>
+int BasicMinPriorityQ<D>::child(int i)
 {
-   return 2*i;
+   return (int)D * (i - 1) + 2;
 }
 
 
 /**
- * @brief Return the right child of a node by index
+ * @brief Return where the key of a node lives in keys. Shifting by
+ * D - 2 starts every group of siblings on a multiple of D slots, so a
+ * group never straddles a cache line.
  *
- * @param i Index to get right child of
+ * @param i - Index of the node
  *
- * @return Key of the right child
+ * @return Slot of the node's key
  */
-int MinPriorityQ::right(int i)
+template <unsigned D>
+int BasicMinPriorityQ<D>::slot(int i)
 {
-   return ((2*i) + 1);
+   return i + (int)D - 2;
+}
+
+
+/**
+ * @brief Swap two nodes by index
+ *
+ * @param i - First node
+ * @param j - Second node
+ */
+template <unsigned D>
+void BasicMinPriorityQ<D>::exchange(int i, int j)
+{
+   swap(nodes[i-1], nodes[j-1]);
+   swap(keys[slot(i)], keys[slot(j)]);
+   position[nodes[i-1]] = i;
+   position[nodes[j-1]] = j;
+}
+
+
+/**
+ * @brief Move a node up while its parent has a larger key
+ *
+ * @param i - Node whose key was set or lowered
+ */
+template <unsigned D>
+void BasicMinPriorityQ<D>::siftUp(int i)
+{
+   PQ_COUNT(sifts, 1);
+   PQ_COUNT(comparisons, i > 1);
+
+   while(i > 1 && keys[slot(parent(i))] > keys[slot(i)])
+   {
+      PQ_COUNT(swaps, 1);
+      PQ_COUNT(siftLevels, 1);
+      PQ_COUNT(comparisons, parent(i) > 1);
+      exchange(i, parent(i));
+      i = parent(i);
+   }
 }
 
 
@@ -99,42 +237,49 @@ int MinPriorityQ::right(int i)
  *
  * @param i Node to test, and fix if required
  */
-void MinPriorityQ::minHeapify(int i)
+template <unsigned D>
+void BasicMinPriorityQ<D>::minHeapify(int i)
 {
-   int l, r, small;
-   small = 0;
-   l = left(i);
-   r = right(i);
+   int first, small;
+   first = child(i);
 
-   if(l <= hSize && ((minHeap[l-1].key) < (minHeap[i-1].key)))
-   {
-      small = l;
-   }
-   else
-   {
-      small = i;
-   }
-   if(r <= hSize && ((minHeap[r-1].key) < (minHeap[small-1].key)))
+   if(first > hSize)
    {
-      small = r;
+      return;
    }
-   if( small != i)
+
+   // slots past hSize hold INT_MAX, so the group is compared whole
+   small = first + smallestKey<D>(&keys[slot(first)]);
+   // D - 1 within the group, one against the parent
+   PQ_COUNT(comparisons, D);
+
+   if((keys[slot(small)]) < (keys[slot(i)]))
    {
-      swap(minHeap[i-1], minHeap[small-1]);
+      PQ_COUNT(swaps, 1);
+      PQ_COUNT(siftLevels, 1);
+      exchange(i, small);
       minHeapify(small);
    }
 }
 
 
 /**
- * @brief Generate a min-heap from an array of ints
+ * @brief Generate a min-heap from an array of ints. insert and
+ * decreaseKey already keep the heap ordered, so on this queue it only
+ * confirms the order in O(n).
  */
-void MinPriorityQ::buildMinHeap()
+template <unsigned D>
+void BasicMinPriorityQ<D>::buildMinHeap()
 {
-   for(int i = floor(hSize/2); i > 0; i--)
+   PQ_SCOPE(counters, PQ_BUILD);
+   PQ_COUNT(heapBuilds, 1);
+
+   for(int i = hSize > 1 ? parent(hSize) : 0; i > 0; i--)
    {
+      PQ_COUNT(sifts, 1);
       minHeapify(i);
    }
+   CHECK_HEAP();
 }
 
 
@@ -143,46 +288,55 @@ void MinPriorityQ::buildMinHeap()
  *
  * @return ID of the element with the minimum key
  */
-string MinPriorityQ::extractMin()
+template <unsigned D>
+string BasicMinPriorityQ<D>::extractMin()
 {
+   PQ_SCOPE(counters, PQ_EXTRACT);
 
-   int length = (int)minHeap.size();
-   if(length <= 0 )
+   if(hSize <= 0 )
    {
       return "empty";
    }
-   Element min = minHeap[0];
-   minHeap[0] = minHeap[length-1];
+   int min = nodes[0];
+   exchange(1, hSize);
+   keys[slot(hSize)] = INT_MAX;
    hSize = hSize - 1;
-   minHeap.resize(hSize);
+   nodes.pop_back();
+   position[min] = 0;
+   setQueued(min, false);
+   PQ_COUNT(sifts, 1);
    minHeapify(1);
-   return min.id;
+   CHECK_HEAP();
+   return ids[min];
 }
 
 
 /**
- * @brief Decrease the key of a value, search by ID
+ * @brief Decrease the key of a value, found through its handle's node
  *
  * @param id ID to search for
- * @param newKey Replace ID's key with this
+ * @param newKey Replace ID's key with this, ignored unless smaller
  */
-void MinPriorityQ::decreaseKey(string id, int newKey)
+template <unsigned D>
+void BasicMinPriorityQ<D>::decreaseKey(const string& id, int newKey)
 {
-   int i,j;
-   j = hSize - 1;
-   for(i = 0; i < hSize; i++)
+   PQ_SCOPE(counters, PQ_DECREASE);
+
+   auto found = handles.find(id);
+
+   if(found == handles.end() || !inQueue(found->second))
    {
+      return;
+   }
 
-      if(minHeap[i].id == id)
-      {
-         if(newKey < minHeap[i].key)
-         {
-            j = i;
-            minHeap[j].key = newKey;
-         }
-      }
+   int i = position[found->second];
+
+   if(newKey < keys[slot(i)])
+   {
+      keys[slot(i)] = newKey;
+      siftUp(i);
    }
-   buildMinHeap();
+   CHECK_HEAP();
 }
 
 
@@ -191,9 +345,10 @@ void MinPriorityQ::decreaseKey(string id, int newKey)
  *
  * @return size of minHeap
  */
-unsigned int MinPriorityQ::minHeapSize()
+template <unsigned D>
+unsigned int BasicMinPriorityQ<D>::minHeapSize()
 {
-   return minHeap.size();
+   return hSize;
 }
 
 
@@ -204,14 +359,81 @@ unsigned int MinPriorityQ::minHeapSize()
  *
  * @return true if in queue, false if not
  */
-bool MinPriorityQ::isMember(string id)
+template <unsigned D>
+bool BasicMinPriorityQ<D>::isMember(const string& id)
+{
+   PQ_SCOPE(counters, PQ_MEMBER);
+
+   auto found = handles.find(id);
+
+   return found != handles.end() && inQueue(found->second);
+}
+
+
+/**
+ * @brief Check every invariant the operations rely on: no node has a
+ * smaller key than its parent, position and the queued bits agree with
+ * the nodes, and the slots after the last node hold INT_MAX
+ *
+ * @return true if the heap is consistent
+ */
+template <unsigned D>
+bool BasicMinPriorityQ<D>::isHeap()
 {
-   for(int i = 0; i < hSize; i++)
+   if((int)nodes.size() != hSize)
    {
-      if((minHeap[i].id == id))
+      return false;
+   }
+
+   for(int i = 1; i <= hSize; i++)
+   {
+      int handle = nodes[i-1];
+
+      if(position[handle] != i || !inQueue(handle))
+      {
+         return false;
+      }
+      if(i > 1 && keys[slot(parent(i))] > keys[slot(i)])
       {
-         return true;
+         return false;
       }
    }
-   return false;
-}
\ No newline at end of file
+
+   int members = 0;
+
+   for(unsigned long long word : queued)
+   {
+      members += __builtin_popcountll(word);
+   }
+
+   for(int j = hSize + 1; j < hSize + (int)D; j++)
+   {
+      if(keys[slot(j)] != INT_MAX)
+      {
+         return false;
+      }
+   }
+   return members == hSize;
+}
+
+
+/**
+ * @brief Snapshot of the operation counters, see pq_stats.h
+ *
+ * @return Counts per operation, all zero without -DPQ_STATS
+ */
+template <unsigned D>
+PQStats BasicMinPriorityQ<D>::stats() const
+{
+#ifdef PQ_STATS
+   return counters;
+#else
+   return PQStats();
+#endif
+}
+
+
+// the arities minpriority.h names
+template class BasicMinPriorityQ<2>;
+template class BasicMinPriorityQ<4>;
+template class BasicMinPriorityQ<8>;
\ No newline at end of file
@@ -2,6 +2,18 @@
  * @file minpriority.h - File contains the helper functions
  * for the implementation and maintainance of the minHeap.
  *
+ * The heap is d-ary: every node has D children whose keys sit together
+ * in one cache line aligned group (heap_keys.h), so a heapify step loads
+ * one line and picks the smallest child with SIMD compares. D = 4 won
+ * the extract and decrease workloads of proj4's pqbench.
+ *
+ * Every id is given a dense handle the first time it is seen. The heap
+ * stores handles, position maps a handle to its node, so decreaseKey
+ * sifts up from there in O(log n), and a bit per handle answers
+ * isMember without searching the heap. Building with -DMINPQ_DEBUG
+ * checks every invariant after each operation, see isHeap, and
+ * -DPQ_STATS counts every operation, see stats and pq_stats.h.
+ *
  * @author - Alex Moxon
  *
  * @date - April 25th 2019
@@ -14,40 +26,57 @@
 
 #include <iostream>
 #include <string>
+#include <unordered_map>
 #include <vector>
+#include "heap_keys.h"
+#include "pq_stats.h"
 
 using namespace std;
 
-class MinPriorityQ
+template <unsigned D>
+class BasicMinPriorityQ
 {
 public:
 
-    MinPriorityQ(int);
-    ~MinPriorityQ();
+    BasicMinPriorityQ(int);
+    ~BasicMinPriorityQ();
 
-    void insert(string, int);
-    void decreaseKey(string, int);
+    void insert(const string&, int);
+    void decreaseKey(const string&, int);
     void buildMinHeap();
 
     unsigned int minHeapSize();
-    bool isMember(string id);
+    bool isMember(const string& id);
     string extractMin();
+    bool isHeap();
+    PQStats stats() const;   // all zero unless built with -DPQ_STATS
 
 private:
-	class Element
-	{
-	public:
-		string id;
-        int key;
-    };
-
-    vector<Element> minHeap;
+    unordered_map<string, int> handles;   // id -> handle
+    vector<string> ids;          // handle -> id
+    vector<int> nodes;           // nodes[i - 1] is the handle at node i
+    vector<int> position;        // handle -> node, 0 when not queued
+    vector<unsigned long long> queued;   // one bit per handle
+    AlignedKeys keys;            // key of node i at slot(i)
+#ifdef PQ_STATS
+    PQStats counters;
+#endif
     void minHeapify(int);
+    void siftUp(int);
+    void exchange(int, int);
+    int intern(const string&);
+    bool inQueue(int);
+    void setQueued(int, bool);
 
     int parent(int);
-    int left(int);
-    int right(int);
+    int child(int);
+    int slot(int);
     int hSize;
 };
 
+// arities instantiated in minpriority.cpp
+typedef BasicMinPriorityQ<4> MinPriorityQ;
+typedef BasicMinPriorityQ<2> BinaryMinPriorityQ;
+typedef BasicMinPriorityQ<8> OctalMinPriorityQ;
+
 #endif
\ No newline at end of file